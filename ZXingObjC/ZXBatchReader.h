@@ -0,0 +1,81 @@
+/*
+ * Copyright 2014 ZXing authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+@class ZXDecodeHints, ZXLuminanceSource, ZXResult;
+
+/**
+ * The outcome of decoding one image of a batch.
+ */
+@interface ZXBatchResult : NSObject
+
+/**
+ * The decoded barcode, or nil if none was found.
+ */
+@property (nonatomic, strong, readonly) ZXResult *result;
+
+/**
+ * Why the image could not be decoded, or nil if it was.
+ */
+@property (nonatomic, strong, readonly) NSError *error;
+
+/**
+ * Time spent binarizing and decoding the image.
+ */
+@property (nonatomic, assign, readonly) CFTimeInterval time;
+
+@end
+
+/**
+ * Decodes many images across several worker threads, for offline processing of archives. Each
+ * worker has its own ZXMultiFormatReader, set up once with the hints, and its own
+ * ZXBinarizerContext, so images of the same size are binarized without reallocating buffers.
+ * The hints are shared by the workers, so a resultPointCallback must be thread safe.
+ */
+@interface ZXBatchReader : NSObject
+
+@property (nonatomic, strong, readonly) ZXDecodeHints *hints;
+
+/**
+ * The number of images decoded at the same time. Defaults to the number of active processors.
+ */
+@property (nonatomic, assign) int concurrency;
+
+/**
+ * The ZXBinarizer subclass used for each image. Defaults to ZXHybridBinarizer.
+ */
+@property (nonatomic, assign) Class binarizerClass;
+
+- (id)initWithHints:(ZXDecodeHints *)hints;
++ (id)readerWithHints:(ZXDecodeHints *)hints;
+
+/**
+ * @param sources ZXLuminanceSource objects to decode
+ * @return A ZXBatchResult for each source, in the same order
+ */
+- (NSArray *)decodeSources:(NSArray *)sources;
+
+/**
+ * Decodes sources as they are produced, without holding them all in memory. The enumerator is
+ * only read by one worker at a time, so it should hand out sources cheaply. At most twice
+ * concurrency sources are taken from it ahead of the last one handled.
+ *
+ * @param sources an enumerator of ZXLuminanceSource objects
+ * @param handler called for each source, in the order of the enumerator, one call at a time on a
+ *  serial queue of its own; this returns once it has been called for every source
+ */
+- (void)decodeSources:(NSEnumerator *)sources handler:(void (^)(NSUInteger index, ZXBatchResult *result))handler;
+
+@end
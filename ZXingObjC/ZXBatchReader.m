@@ -0,0 +1,131 @@
+/*
+ * Copyright 2014 ZXing authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "ZXBatchReader.h"
+#import "ZXBinarizerContext.h"
+#import "ZXBinaryBitmap.h"
+#import "ZXDecodeHints.h"
+#import "ZXHybridBinarizer.h"
+#import "ZXMultiFormatReader.h"
+
+@interface ZXBatchResult ()
+
+- (id)initWithResult:(ZXResult *)result error:(NSError *)error time:(CFTimeInterval)time;
+
+@end
+
+@implementation ZXBatchResult
+
+- (id)initWithResult:(ZXResult *)result error:(NSError *)error time:(CFTimeInterval)time {
+  if (self = [super init]) {
+    _result = result;
+    _error = error;
+    _time = time;
+  }
+
+  return self;
+}
+
+@end
+
+@implementation ZXBatchReader
+
+- (id)initWithHints:(ZXDecodeHints *)hints {
+  if (self = [super init]) {
+    _hints = hints;
+    _concurrency = (int)[[NSProcessInfo processInfo] activeProcessorCount];
+    _binarizerClass = [ZXHybridBinarizer class];
+  }
+
+  return self;
+}
+
++ (id)readerWithHints:(ZXDecodeHints *)hints {
+  return [[self alloc] initWithHints:hints];
+}
+
+- (NSArray *)decodeSources:(NSArray *)sources {
+  NSMutableArray *results = [NSMutableArray arrayWithCapacity:sources.count];
+  [self decodeSources:[sources objectEnumerator] handler:^(NSUInteger index, ZXBatchResult *result) {
+    [results addObject:result];
+  }];
+  return results;
+}
+
+- (void)decodeSources:(NSEnumerator *)sources handler:(void (^)(NSUInteger index, ZXBatchResult *result))handler {
+  int concurrency = MAX(1, self.concurrency);
+  NSObject *sourceLock = [[NSObject alloc] init];
+  NSObject *resultLock = [[NSObject alloc] init];
+  __block NSUInteger nextIndex = 0;
+  __block NSUInteger nextHandledIndex = 0;
+  // Results finished ahead of an earlier source, waiting for it to be handed to the handler
+  NSMutableDictionary *pending = [NSMutableDictionary dictionary];
+  // The handler is called here, in order and outside both locks, so a slow handler holds up
+  // neither fetching sources nor workers finishing theirs
+  dispatch_queue_t handlerQueue = dispatch_queue_create("com.zxing.batchReaderHandlerQueue", NULL);
+  // Sources taken but not yet handled; a source that is slow to decode can only hold up this many
+  // results behind it
+  dispatch_semaphore_t inFlight = dispatch_semaphore_create(2 * concurrency);
+
+  dispatch_apply(concurrency, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t worker) {
+    ZXMultiFormatReader *reader = [ZXMultiFormatReader reader];
+    reader.hints = self.hints;
+    reader.binarizerContext = [ZXBinarizerContext context];
+
+    while (YES) {
+      dispatch_semaphore_wait(inFlight, DISPATCH_TIME_FOREVER);
+      ZXLuminanceSource *source;
+      NSUInteger index;
+      @synchronized (sourceLock) {
+        source = [sources nextObject];
+        index = nextIndex++;
+      }
+      if (!source) {
+        dispatch_semaphore_signal(inFlight);
+        break;
+      }
+
+      ZXBatchResult *batchResult;
+      @autoreleasepool {
+        CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+        ZXBinaryBitmap *bitmap = [ZXBinaryBitmap binaryBitmapWithBinarizer:[self.binarizerClass binarizerWithSource:source]];
+        NSError *error = nil;
+        ZXResult *result = [reader decodeWithState:bitmap error:&error];
+        batchResult = [[ZXBatchResult alloc] initWithResult:result error:result ? nil : error
+                                                       time:CFAbsoluteTimeGetCurrent() - start];
+      }
+
+      @synchronized (resultLock) {
+        pending[@(index)] = batchResult;
+        ZXBatchResult *next;
+        while ((next = pending[@(nextHandledIndex)]) != nil) {
+          [pending removeObjectForKey:@(nextHandledIndex)];
+          NSUInteger handledIndex = nextHandledIndex++;
+          // Queued while holding the lock, so calls keep the order of the sources
+          dispatch_async(handlerQueue, ^{
+            handler(handledIndex, next);
+            dispatch_semaphore_signal(inFlight);
+          });
+        }
+      }
+    }
+  });
+
+  // Wait for the last calls to the handler
+  dispatch_sync(handlerQueue, ^{});
+}
+
+@end
@@ -16,7 +16,25 @@
 
 #import "ZXReader.h"
 
-@class ZXDecodeHints;
+@class ZXBinarizerContext, ZXDecodeHints;
+
+/**
+ * How often one of the readers of a ZXMultiFormatReader found a barcode, and how long it took.
+ */
+@interface ZXReaderStatistics : NSObject
+
+@property (nonatomic, strong, readonly) id<ZXReader> reader;
+@property (nonatomic, assign, readonly) int attemptCount;
+@property (nonatomic, assign, readonly) int hitCount;
+@property (nonatomic, assign, readonly) CFTimeInterval totalTime;
+
+/**
+ * @return The expected time spent per barcode found, the average time of an attempt divided by
+ *         the estimated probability of a hit, or HUGE_VAL if the reader was never tried
+ */
+- (CFTimeInterval)expectedTimePerHit;
+
+@end
 
 /**
  * ZXMultiFormatReader is a convenience class and the main entry point into the library for most uses.
@@ -27,6 +45,35 @@
 
 @property (nonatomic, strong) ZXDecodeHints *hints;
 
+/**
+ * An optional context handed to the binarizer of each decoded image, so continuous scan clients
+ * calling decodeWithState: reuse the same scratch buffers and output matrix for every frame.
+ * The matrix of a decoded image is only valid until the next image is decoded.
+ */
+@property (nonatomic, strong) ZXBinarizerContext *binarizerContext;
+
+/**
+ * When set, the readers are reordered after each decode so that the ones with the lowest expected
+ * time per barcode found are tried first. Readers which have not been tried yet keep their place
+ * after the others. Useful for continuous scan clients which mostly see a single format. The
+ * statistics start over, and the readers go back to the order the hints give them, when the hints
+ * change or reset is called.
+ */
+@property (nonatomic, assign) BOOL adaptiveReaderOrder;
+
+/**
+ * When set, the readers run at the same time on a global dispatch queue and the first barcode
+ * found is returned, so a decode takes about as long as the slowest reader rather than all of
+ * them together. The others are cancelled through a ZXCancellationToken in the hints they get.
+ * The image is binarized once up front and shared read-only by the 2D readers.
+ */
+@property (nonatomic, assign) BOOL parallelDecode;
+
+/**
+ * ZXReaderStatistics of each reader, in the order the readers are currently tried.
+ */
+@property (nonatomic, strong, readonly) NSArray *readerStatistics;
+
 + (id)reader;
 
 /**
@@ -39,3 +86,19 @@
 - (ZXResult *)decodeWithState:(ZXBinaryBitmap *)image error:(NSError **)error;
 
 @end
+
+/**
+ * A reader which, unlike ZXMultiFormatReader, may be used from several threads at once, so that
+ * one instance can serve a whole thread pool. Each decode borrows an idle ZXMultiFormatReader set
+ * up with the hints given at creation, creating one when none is idle, and returns it afterwards.
+ * There are never more readers than decodes that ran at the same time. Each thread must still
+ * decode its own ZXBinaryBitmap, see ZXReader.
+ */
+@interface ZXSharedMultiFormatReader : NSObject <ZXReader>
+
+@property (nonatomic, strong, readonly) ZXDecodeHints *hints;
+
+- (id)initWithHints:(ZXDecodeHints *)hints;
++ (id)readerWithHints:(ZXDecodeHints *)hints;
+
+@end
@@ -15,10 +15,13 @@
  */
 
 #import "ZXAztecReader.h"
+#import "ZXBinarizerContext.h"
 #import "ZXBinaryBitmap.h"
+#import "ZXCancellationToken.h"
 #import "ZXDataMatrixReader.h"
 #import "ZXDecodeHints.h"
 #import "ZXErrors.h"
+#import "ZXHybridBinarizer.h"
 #import "ZXMaxiCodeReader.h"
 #import "ZXMultiFormatOneDReader.h"
 #import "ZXMultiFormatReader.h"
@@ -26,9 +29,53 @@
 #import "ZXQRCodeReader.h"
 #import "ZXResult.h"
 
+@interface ZXReaderStatistics ()
+
+- (id)initWithReader:(id<ZXReader>)reader;
+- (void)addAttempt:(BOOL)hit time:(CFTimeInterval)time;
+
+@end
+
+@implementation ZXReaderStatistics
+
+- (id)initWithReader:(id<ZXReader>)reader {
+  if (self = [super init]) {
+    _reader = reader;
+  }
+
+  return self;
+}
+
+- (void)addAttempt:(BOOL)hit time:(CFTimeInterval)time {
+  _attemptCount++;
+  if (hit) {
+    _hitCount++;
+  }
+  _totalTime += time;
+}
+
+- (CFTimeInterval)expectedTimePerHit {
+  if (self.attemptCount == 0) {
+    return HUGE_VAL;
+  }
+  // Laplace smoothing keeps a reader which has not found anything yet from being ruled out
+  double hitRate = (self.hitCount + 1.0) / (self.attemptCount + 2.0);
+  return self.totalTime / self.attemptCount / hitRate;
+}
+
+- (NSString *)description {
+  return [NSString stringWithFormat:@"%@: %d/%d hits, %.3f ms per attempt", [(id)self.reader class],
+          self.hitCount, self.attemptCount, self.attemptCount == 0 ? 0.0 : self.totalTime * 1000.0 / self.attemptCount];
+}
+
+@end
+
 @interface ZXMultiFormatReader ()
 
 @property (nonatomic, strong, readonly) NSMutableArray *readers;
+@property (nonatomic, strong) NSArray *readerStatistics;
+// The readers in the order the hints gave them, before adaptiveReaderOrder moved them
+@property (nonatomic, strong) NSArray *hintReaderOrder;
 
 @end
 
@@ -37,6 +84,7 @@
 - (id)init {
   if (self = [super init]) {
     _readers = [NSMutableArray array];
+    _readerStatistics = @[];
   }
 
   return self;
@@ -137,6 +185,8 @@
       [self.readers addObject:[[ZXMultiFormatOneDReader alloc] initWithHints:hints]];
     }
   }
+  self.hintReaderOrder = [self.readers copy];
+  [self resetReaderStatistics];
 }
 
 - (void)reset {
@@ -145,20 +195,184 @@
       [reader reset];
     }
   }
+  [self resetReaderStatistics];
+}
+
+- (void)resetReaderStatistics {
+  if (self.hintReaderOrder != nil) {
+    [self.readers setArray:self.hintReaderOrder];
+  }
+  NSMutableArray *readerStatistics = [NSMutableArray arrayWithCapacity:self.readers.count];
+  for (id<ZXReader> reader in self.readers) {
+    [readerStatistics addObject:[[ZXReaderStatistics alloc] initWithReader:reader]];
+  }
+  self.readerStatistics = readerStatistics;
+}
+
+/**
+ * Sorts the readers by expected time per hit, which minimizes the expected time to the first hit
+ * if the readers succeed independently. The sort is stable so ties keep their current order.
+ */
+- (void)reorderReaders {
+  NSArray *sorted = [self.readerStatistics sortedArrayWithOptions:NSSortStable usingComparator:^NSComparisonResult(ZXReaderStatistics *a, ZXReaderStatistics *b) {
+    CFTimeInterval aTime = [a expectedTimePerHit];
+    CFTimeInterval bTime = [b expectedTimePerHit];
+    return aTime < bTime ? NSOrderedAscending : aTime > bTime ? NSOrderedDescending : NSOrderedSame;
+  }];
+  if ([sorted isEqualToArray:self.readerStatistics]) {
+    return;
+  }
+  self.readerStatistics = sorted;
+  [self.readers removeAllObjects];
+  for (ZXReaderStatistics *statistics in sorted) {
+    [self.readers addObject:statistics.reader];
+  }
+}
+
+- (void)configureBinarizer:(ZXBinarizer *)binarizer {
+  if (self.hints.binarizerConcurrency > 1 && [binarizer isKindOfClass:[ZXHybridBinarizer class]]) {
+    ((ZXHybridBinarizer *)binarizer).concurrency = self.hints.binarizerConcurrency;
+  }
+  if (self.binarizerContext != nil && [binarizer isKindOfClass:[ZXGlobalHistogramBinarizer class]]) {
+    ((ZXGlobalHistogramBinarizer *)binarizer).context = self.binarizerContext;
+  }
 }
 
 - (ZXResult *)decodeInternal:(ZXBinaryBitmap *)image error:(NSError **)error {
-  if (self.readers != nil) {
-    for (id<ZXReader> reader in self.readers) {
-      ZXResult *result = [reader decode:image hints:self.hints error:nil];
+  [self configureBinarizer:image.binarizer];
+
+  ZXResult *result = nil;
+  if (self.parallelDecode && self.readerStatistics.count > 1 && [image blackMatrixWithError:nil]) {
+    result = [self decodeConcurrently:image];
+  } else {
+    for (ZXReaderStatistics *statistics in self.readerStatistics) {
+      CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+      result = [statistics.reader decode:image hints:self.hints error:nil];
+      [statistics addAttempt:result != nil time:CFAbsoluteTimeGetCurrent() - start];
       if (result) {
-        return result;
+        break;
       }
     }
   }
 
-  if (error) *error = ZXNotFoundErrorInstance();
-  return nil;
+  if (self.adaptiveReaderOrder) {
+    [self reorderReaders];
+  }
+
+  if (!result) {
+    if (error) *error = ZXNotFoundErrorInstance();
+  }
+  return result;
+}
+
+/**
+ * Runs the readers at the same time and returns the first result found. The black matrix has
+ * already been built, so the 2D readers only read it and only the 1D reader binarizes rows. The
+ * first reader to succeed cancels the others; this waits for them to stop, so the readers are
+ * free to be used again when it returns. Cancelled attempts are left out of the statistics.
+ */
+- (ZXResult *)decodeConcurrently:(ZXBinaryBitmap *)image {
+  ZXDecodeHints *hints = self.hints != nil ? [self.hints copy] : [ZXDecodeHints hints];
+  ZXCancellationToken *cancellationToken = [ZXCancellationToken tokenWithParent:hints.cancellationToken];
+  hints.cancellationToken = cancellationToken;
+
+  NSArray *readerStatistics = self.readerStatistics;
+  __block ZXResult *result = nil;
+  dispatch_apply(readerStatistics.count, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t i) {
+    if (cancellationToken.isCancelled) {
+      return;
+    }
+    ZXReaderStatistics *statistics = readerStatistics[i];
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    ZXResult *readerResult = [statistics.reader decode:image hints:hints error:nil];
+    CFTimeInterval time = CFAbsoluteTimeGetCurrent() - start;
+    @synchronized (cancellationToken) {
+      if (readerResult && !result) {
+        result = readerResult;
+        [cancellationToken cancel];
+        [statistics addAttempt:YES time:time];
+      } else if (!cancellationToken.isCancelled) {
+        [statistics addAttempt:NO time:time];
+      }
+    }
+  });
+  return result;
+}
+
+@end
+
+@interface ZXSharedMultiFormatReader ()
+
+@property (nonatomic, strong, readonly) NSMutableArray *idleReaders;
+
+@end
+
+@implementation ZXSharedMultiFormatReader
+
+- (id)initWithHints:(ZXDecodeHints *)hints {
+  if (self = [super init]) {
+    _hints = [hints copy];
+    _idleReaders = [NSMutableArray array];
+  }
+
+  return self;
+}
+
++ (id)readerWithHints:(ZXDecodeHints *)hints {
+  return [[self alloc] initWithHints:hints];
+}
+
+/**
+ * Decodes with the hints given at creation.
+ */
+- (ZXResult *)decode:(ZXBinaryBitmap *)image error:(NSError **)error {
+  ZXMultiFormatReader *reader = [self borrowReader];
+  ZXResult *result = [reader decodeWithState:image error:error];
+  [self returnReader:reader];
+  return result;
+}
+
+/**
+ * Decodes with other hints than those given at creation. The reader is set up for these hints
+ * and back again for each call, so prefer decode:error: for repeated use.
+ */
+- (ZXResult *)decode:(ZXBinaryBitmap *)image hints:(ZXDecodeHints *)hints error:(NSError **)error {
+  ZXMultiFormatReader *reader = [self borrowReader];
+  ZXResult *result = [reader decode:image hints:hints error:error];
+  reader.hints = self.hints;
+  [self returnReader:reader];
+  return result;
+}
+
+/**
+ * Resets the readers which are not decoding.
+ */
+- (void)reset {
+  @synchronized (self.idleReaders) {
+    for (ZXMultiFormatReader *reader in self.idleReaders) {
+      [reader reset];
+    }
+  }
+}
+
+- (ZXMultiFormatReader *)borrowReader {
+  @synchronized (self.idleReaders) {
+    ZXMultiFormatReader *reader = [self.idleReaders lastObject];
+    if (reader) {
+      [self.idleReaders removeLastObject];
+      return reader;
+    }
+  }
+
+  ZXMultiFormatReader *reader = [ZXMultiFormatReader reader];
+  reader.hints = self.hints;
+  return reader;
+}
+
+- (void)returnReader:(ZXMultiFormatReader *)reader {
+  @synchronized (self.idleReaders) {
+    [self.idleReaders addObject:reader];
+  }
 }
 
 @end
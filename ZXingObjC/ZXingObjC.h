@@ -28,6 +28,7 @@
 #import "ZXingObjCQRCode.h"
 #import "ZXingObjCPDF417.h"
 
+#import "ZXBatchReader.h"
 #import "ZXMultiFormatReader.h"
 #import "ZXMultiFormatWriter.h"
 
@@ -19,6 +19,7 @@
 #import "ZXAztecDetectorResult.h"
 #import "ZXAztecReader.h"
 #import "ZXBinaryBitmap.h"
+#import "ZXCancellationToken.h"
 #import "ZXDecodeHints.h"
 #import "ZXDecoderResult.h"
 #import "ZXReader.h"
@@ -47,7 +48,7 @@
     decoderResult = [[[ZXAztecDecoder alloc] init] decode:detectorResult error:error];
   }
 
-  if (decoderResult == nil) {
+  if (decoderResult == nil && !hints.cancellationToken.isCancelled) {
     detectorResult = [detector detectWithMirror:YES error:nil];
     points = detectorResult.points;
     if (detectorResult) {
@@ -78,6 +79,8 @@
   if (ecLevel != nil) {
     [result putMetadata:kResultMetadataTypeErrorCorrectionLevel value:ecLevel];
   }
+  [result putMetadata:kResultMetadataTypeDetectionCandidateCount value:@(detector.candidateUpdateCount)];
+  [result putMetadata:kResultMetadataTypeDetectionResultPointCount value:@(detector.resultPointAllocationCount)];
 
   return result;
 }
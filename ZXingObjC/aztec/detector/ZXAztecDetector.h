@@ -31,6 +31,18 @@
  */
 @interface ZXAztecDetector : NSObject
 
+/**
+ * @return The number of points this detector tracked while searching, in plain C structs. Each
+ *         used to be a ZXAztecPoint object.
+ */
+@property (nonatomic, assign, readonly) int candidateUpdateCount;
+
+/**
+ * @return The number of ZXResultPoint objects this detector created, for the bull's eye and
+ *         matrix corners.
+ */
+@property (nonatomic, assign, readonly) int resultPointAllocationCount;
+
 - (id)initWithImage:(ZXBitMatrix *)image;
 
 - (ZXAztecDetectorResult *)detectWithError:(NSError **)error;
@@ -45,6 +45,20 @@
 
 @end
 
+/**
+ * The struct counterpart of ZXAztecPoint, used while walking out from the bull's eye center so
+ * that no objects are allocated until the corner points are known.
+ */
+typedef struct {
+  int x;
+  int y;
+} ZXAztecIntPoint;
+
+static inline ZXAztecIntPoint ZXAztecIntPointMake(int x, int y) {
+  ZXAztecIntPoint point = {x, y};
+  return point;
+}
+
 @interface ZXAztecDetector ()
 
 @property (nonatomic, assign, getter = isCompact) BOOL compact;
@@ -71,11 +85,7 @@
 
 - (ZXAztecDetectorResult *)detectWithMirror:(BOOL)isMirror error:(NSError **)error {
   // 1. Get the center of the aztec matrix
-  ZXAztecPoint *pCenter = [self matrixCenter];
-  if (!pCenter) {
-    if (error) *error = ZXNotFoundErrorInstance();
-    return nil;
-  }
+  ZXAztecIntPoint pCenter = [self matrixCenter];
 
   // 2. Get the center points of the four diagonal points just outside the bull's eye
   //  [topRight, bottomRight, bottomLeft, topLeft]
@@ -281,19 +291,19 @@ int bitCount(uint32_t i) {
  * @param pCenter Center point
  * @return The corners of the bull-eye, or nil if no valid bull-eye can be found
  */
-- (NSMutableArray *)bullsEyeCorners:(ZXAztecPoint *)pCenter {
-  ZXAztecPoint *pina = pCenter;
-  ZXAztecPoint *pinb = pCenter;
-  ZXAztecPoint *pinc = pCenter;
-  ZXAztecPoint *pind = pCenter;
+- (NSMutableArray *)bullsEyeCorners:(ZXAztecIntPoint)pCenter {
+  ZXAztecIntPoint pina = pCenter;
+  ZXAztecIntPoint pinb = pCenter;
+  ZXAztecIntPoint pinc = pCenter;
+  ZXAztecIntPoint pind = pCenter;
 
   BOOL color = YES;
 
   for (self.nbCenterLayers = 1; self.nbCenterLayers < 9; self.nbCenterLayers++) {
-    ZXAztecPoint *pouta = [self firstDifferent:pina color:color dx:1 dy:-1];
-    ZXAztecPoint *poutb = [self firstDifferent:pinb color:color dx:1 dy:1];
-    ZXAztecPoint *poutc = [self firstDifferent:pinc color:color dx:-1 dy:1];
-    ZXAztecPoint *poutd = [self firstDifferent:pind color:color dx:-1 dy:-1];
+    ZXAztecIntPoint pouta = [self firstDifferent:pina color:color dx:1 dy:-1];
+    ZXAztecIntPoint poutb = [self firstDifferent:pinb color:color dx:1 dy:1];
+    ZXAztecIntPoint poutc = [self firstDifferent:pinc color:color dx:-1 dy:1];
+    ZXAztecIntPoint poutd = [self firstDifferent:pind color:color dx:-1 dy:-1];
 
     //d      a
     //
@@ -326,6 +336,7 @@ int bitCount(uint32_t i) {
   ZXResultPoint *pinbx = [[ZXResultPoint alloc] initWithX:pinb.x + 0.5f y:pinb.y + 0.5f];
   ZXResultPoint *pincx = [[ZXResultPoint alloc] initWithX:pinc.x - 0.5f y:pinc.y + 0.5f];
   ZXResultPoint *pindx = [[ZXResultPoint alloc] initWithX:pind.x - 0.5f y:pind.y - 0.5f];
+  _resultPointAllocationCount += 4;
 
   // Expand the square so that its corners are the centers of the points
   // just outside the bull's eye.
@@ -337,60 +348,55 @@ int bitCount(uint32_t i) {
 /**
  * Finds a candidate center point of an Aztec code from an image
  */
-- (ZXAztecPoint *)matrixCenter {
-  ZXResultPoint *pointA;
-  ZXResultPoint *pointB;
-  ZXResultPoint *pointC;
-  ZXResultPoint *pointD;
-
+- (ZXAztecIntPoint)matrixCenter {
   ZXWhiteRectangleDetector *detector = [[ZXWhiteRectangleDetector alloc] initWithImage:self.image error:nil];
   NSArray *cornerPoints = [detector detectWithError:nil];
 
-  if (cornerPoints) {
-    pointA = cornerPoints[0];
-    pointB = cornerPoints[1];
-    pointC = cornerPoints[2];
-    pointD = cornerPoints[3];
-  } else {
-    // This exception can be in case the initial rectangle is white
-    // In that case, surely in the bull's eye, we try to expand the rectangle.
-    int cx = self.image.width / 2;
-    int cy = self.image.height / 2;
-    pointA = [[self firstDifferent:[[ZXAztecPoint alloc] initWithX:cx + 7 y:cy - 7] color:NO dx:1 dy:-1] toResultPoint];
-    pointB = [[self firstDifferent:[[ZXAztecPoint alloc] initWithX:cx + 7 y:cy + 7]  color:NO dx:1 dy:1] toResultPoint];
-    pointC = [[self firstDifferent:[[ZXAztecPoint alloc] initWithX:cx - 7 y:cy + 7]  color:NO dx:-1 dy:1] toResultPoint];
-    pointD = [[self firstDifferent:[[ZXAztecPoint alloc] initWithX:cx - 7 y:cy - 7]  color:NO dx:-1 dy:-1] toResultPoint];
-  }
-
   //Compute the center of the rectangle
-  int cx = [ZXMathUtils round:([pointA x] + [pointD x] + [pointB x] + [pointC x]) / 4.0f];
-  int cy = [ZXMathUtils round:([pointA y] + [pointD y] + [pointB y] + [pointC y]) / 4.0f];
+  ZXAztecIntPoint center = [self centerOfCorners:cornerPoints aroundX:self.image.width / 2 y:self.image.height / 2];
 
   // Redetermine the white rectangle starting from previously computed center.
   // This will ensure that we end up with a white rectangle in center bull's eye
   // in order to compute a more accurate center.
-  detector = [[ZXWhiteRectangleDetector alloc] initWithImage:self.image initSize:15 x:cx y:cy error:nil];
+  detector = [[ZXWhiteRectangleDetector alloc] initWithImage:self.image initSize:15 x:center.x y:center.y error:nil];
   cornerPoints = [detector detectWithError:nil];
 
+  // Recompute the center of the rectangle
+  return [self centerOfCorners:cornerPoints aroundX:center.x y:center.y];
+}
+
+/**
+ * @return The center of the white rectangle with the given corners, or if the rectangle could
+ *         not be detected, of the one found by expanding out from (cx, cy)
+ */
+- (ZXAztecIntPoint)centerOfCorners:(NSArray *)cornerPoints aroundX:(int)cx y:(int)cy {
+  float x[4];
+  float y[4];
   if (cornerPoints) {
-    pointA = cornerPoints[0];
-    pointB = cornerPoints[1];
-    pointC = cornerPoints[2];
-    pointD = cornerPoints[3];
+    for (int i = 0; i < 4; i++) {
+      ZXResultPoint *corner = cornerPoints[i];
+      x[i] = corner.x;
+      y[i] = corner.y;
+    }
   } else {
     // This exception can be in case the initial rectangle is white
-    // In that case we try to expand the rectangle.
-    pointA = [[self firstDifferent:[[ZXAztecPoint alloc] initWithX:cx + 7 y:cy - 7]  color:NO dx:1 dy:-1] toResultPoint];
-    pointB = [[self firstDifferent:[[ZXAztecPoint alloc] initWithX:cx + 7 y:cy + 7]  color:NO dx:1 dy:1] toResultPoint];
-    pointC = [[self firstDifferent:[[ZXAztecPoint alloc] initWithX:cx - 7 y:cy + 7]  color:NO dx:-1 dy:1] toResultPoint];
-    pointD = [[self firstDifferent:[[ZXAztecPoint alloc] initWithX:cx - 7 y:cy - 7] color:NO dx:-1 dy:-1] toResultPoint];
+    // In that case, surely in the bull's eye, we try to expand the rectangle.
+    ZXAztecIntPoint points[4] = {
+      [self firstDifferent:ZXAztecIntPointMake(cx + 7, cy - 7) color:NO dx:1 dy:-1],
+      [self firstDifferent:ZXAztecIntPointMake(cx + 7, cy + 7) color:NO dx:1 dy:1],
+      [self firstDifferent:ZXAztecIntPointMake(cx - 7, cy + 7) color:NO dx:-1 dy:1],
+      [self firstDifferent:ZXAztecIntPointMake(cx - 7, cy - 7) color:NO dx:-1 dy:-1]
+    };
+    for (int i = 0; i < 4; i++) {
+      x[i] = points[i].x;
+      y[i] = points[i].y;
+    }
+    _candidateUpdateCount += 4;
   }
 
-  cx = [ZXMathUtils round:([pointA x] + [pointD x] + [pointB x] + [pointC x]) / 4];
-  cy = [ZXMathUtils round:([pointA y] + [pointD y] + [pointB y] + [pointC y]) / 4];
-
-  // Recompute the center of the rectangle
-  return [[ZXAztecPoint alloc] initWithX:cx y:cy];
+  _candidateUpdateCount++;
+  return ZXAztecIntPointMake([ZXMathUtils round:(x[0] + x[3] + x[1] + x[2]) / 4.0f],
+                             [ZXMathUtils round:(y[0] + y[3] + y[1] + y[2]) / 4.0f]);
 }
 
 /**
@@ -450,8 +456,10 @@ int bitCount(uint32_t i) {
   float py = p1.y;
   float dx = moduleSize * (p2.x - p1.x) / d;
   float dy = moduleSize * (p2.y - p1.y) / d;
+  int32_t *bits = self.image.bits;
+  int rowSize = self.image.rowSize;
   for (int i = 0; i < size; i++) {
-    if ([self.image getX:[ZXMathUtils round:px + i * dx] y:[ZXMathUtils round:py + i * dy]]) {
+    if (ZXBitMatrixGetBit(bits, rowSize, [ZXMathUtils round:px + i * dx], [ZXMathUtils round:py + i * dy])) {
       result |= 1 << (size - i - 1);
     }
   }
@@ -463,13 +471,14 @@ int bitCount(uint32_t i) {
  * @return true if the border of the rectangle passed in parameter is compound of white points only
  *         or black points only
  */
-- (BOOL)isWhiteOrBlackRectangle:(ZXAztecPoint *)p1 p2:(ZXAztecPoint *)p2 p3:(ZXAztecPoint *)p3 p4:(ZXAztecPoint *)p4 {
+- (BOOL)isWhiteOrBlackRectangle:(ZXAztecIntPoint)p1 p2:(ZXAztecIntPoint)p2 p3:(ZXAztecIntPoint)p3 p4:(ZXAztecIntPoint)p4 {
   int corr = 3;
 
-  p1 = [[ZXAztecPoint alloc] initWithX:p1.x - corr y:p1.y + corr];
-  p2 = [[ZXAztecPoint alloc] initWithX:p2.x - corr y:p2.y - corr];
-  p3 = [[ZXAztecPoint alloc] initWithX:p3.x + corr y:p3.y - corr];
-  p4 = [[ZXAztecPoint alloc] initWithX:p4.x + corr y:p4.y + corr];
+  p1 = ZXAztecIntPointMake(p1.x - corr, p1.y + corr);
+  p2 = ZXAztecIntPointMake(p2.x - corr, p2.y - corr);
+  p3 = ZXAztecIntPointMake(p3.x + corr, p3.y - corr);
+  p4 = ZXAztecIntPointMake(p4.x + corr, p4.y + corr);
+  _candidateUpdateCount += 4;
 
   int cInit = [self color:p4 p2:p1];
 
@@ -499,7 +508,7 @@ int bitCount(uint32_t i) {
  *
  * @return 1 if segment more than 90% black, -1 if segment is more than 90% white, 0 else
  */
-- (int)color:(ZXAztecPoint *)p1 p2:(ZXAztecPoint *)p2 {
+- (int)color:(ZXAztecIntPoint)p1 p2:(ZXAztecIntPoint)p2 {
   float d = [self distance:p1 b:p2];
   float dx = (p2.x - p1.x) / d;
   float dy = (p2.y - p1.y) / d;
@@ -508,12 +517,14 @@ int bitCount(uint32_t i) {
   float px = p1.x;
   float py = p1.y;
 
-  BOOL colorModel = [self.image getX:p1.x y:p1.y];
+  int32_t *bits = self.image.bits;
+  int rowSize = self.image.rowSize;
+  BOOL colorModel = ZXBitMatrixGetBit(bits, rowSize, p1.x, p1.y);
 
   for (int i = 0; i < d; i++) {
     px += dx;
     py += dy;
-    if ([self.image getX:[ZXMathUtils round:px] y:[ZXMathUtils round:py]] != colorModel) {
+    if (ZXBitMatrixGetBit(bits, rowSize, [ZXMathUtils round:px], [ZXMathUtils round:py]) != colorModel) {
       error++;
     }
   }
@@ -530,29 +541,28 @@ int bitCount(uint32_t i) {
 /**
  * Gets the coordinate of the first point with a different color in the given direction
  */
-- (ZXAztecPoint *)firstDifferent:(ZXAztecPoint *)init color:(BOOL)color dx:(int)dx dy:(int)dy {
-  int x = init.x + dx;
-  int y = init.y + dy;
+- (ZXAztecIntPoint)firstDifferent:(ZXAztecIntPoint)init color:(BOOL)color dx:(int)dx dy:(int)dy {
+  int run = [self validRunLengthFromX:init.x + dx y:init.y + dy dx:dx dy:dy color:color];
+  int x = init.x + run * dx;
+  int y = init.y + run * dy;
 
-  while ([self isValidX:x y:y] && [self.image getX:x y:y] == color) {
-    x += dx;
-    y += dy;
-  }
-
-  x -= dx;
-  y -= dy;
+  run = [self validRunLengthFromX:x y:y dx:dx dy:0 color:color];
+  x += (run - 1) * dx;
 
-  while ([self isValidX:x y:y] && [self.image getX:x y:y] == color) {
-    x += dx;
-  }
-  x -= dx;
+  run = [self validRunLengthFromX:x y:y dx:0 dy:dy color:color];
+  y += (run - 1) * dy;
 
-  while ([self isValidX:x y:y] && [self.image getX:x y:y] == color) {
-    y += dy;
-  }
-  y -= dy;
+  _candidateUpdateCount++;
+  return ZXAztecIntPointMake(x, y);
+}
 
-  return [[ZXAztecPoint alloc] initWithX:x y:y];
+/**
+ * Counts the valid points of the given color starting at (x, y) in the given direction.
+ */
+- (int)validRunLengthFromX:(int)x y:(int)y dx:(int)dx dy:(int)dy color:(BOOL)color {
+  // Row 0 is not valid, see isValidX:y:
+  int maxCount = y <= 0 ? 0 : dy < 0 ? y : INT_MAX;
+  return [self.image runLengthFromX:x y:y dx:dx dy:dy value:color maxCount:maxCount];
 }
 
 /**
@@ -584,6 +594,7 @@ int bitCount(uint32_t i) {
   centery = (cornerPoints1.y + cornerPoints3.y) / 2.0f;
   ZXResultPoint *result1 = [[ZXResultPoint alloc] initWithX:centerx + ratio * dx y:centery + ratio * dy];
   ZXResultPoint *result3 = [[ZXResultPoint alloc] initWithX:centerx - ratio * dx y:centery - ratio * dy];
+  _resultPointAllocationCount += 4;
 
   return @[result0, result1, result2, result3];
 }
@@ -598,7 +609,7 @@ int bitCount(uint32_t i) {
   return [self isValidX:x y:y];
 }
 
-- (float)distance:(ZXAztecPoint *)a b:(ZXAztecPoint *)b {
+- (float)distance:(ZXAztecIntPoint)a b:(ZXAztecIntPoint)b {
   return [ZXMathUtils distance:a.x aY:a.y bX:b.x bY:b.y];
 }
 
@@ -173,6 +173,12 @@
   return matrix;
 }
 
+- (int8_t *)luminancesWithRowStride:(int *)rowStride inverted:(BOOL *)inverted {
+  if (rowStride) *rowStride = self.width;
+  if (inverted) *inverted = NO;
+  return self.data;
+}
+
 - (void)initializeWithImage:(CGImageRef)cgimage left:(size_t)left top:(size_t)top width:(size_t)width height:(size_t)height {
   _data = 0;
   _image = CGImageRetain(cgimage);
@@ -0,0 +1,66 @@
+/*
+ * Copyright 2014 ZXing authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+@class ZXBitMatrix, ZXByteArray, ZXIntArray;
+
+/**
+ * Owns the scratch buffers and output matrix used by ZXHybridBinarizer and
+ * ZXGlobalHistogramBinarizer, so that continuous scanning clients binarizing many frames of the
+ * same size do not reallocate them for every frame. Buffers are reset rather than reallocated
+ * while the dimensions stay the same.
+ *
+ * A context must only be used by one binarization at a time. The matrix it hands out is reused,
+ * so a ZXBitMatrix obtained from a binarizer using a context is only valid until the next frame
+ * is binarized with that context.
+ */
+@interface ZXBinarizerContext : NSObject
+
+/**
+ * @return The number of times a buffer or the matrix had to be allocated, useful to check that
+ *         frames are in fact being binarized without allocating.
+ */
+@property (nonatomic, assign, readonly) int allocationCount;
+
++ (id)context;
+
+/**
+ * @param count The number of ints required
+ * @return A buffer of at least count ints with undefined contents
+ */
+- (int *)blackPointsWithCount:(int)count;
+
+/**
+ * @param count The number of ints required
+ * @return A buffer of at least count ints with undefined contents, distinct from blackPoints
+ */
+- (int *)scratchWithCount:(int)count;
+
+/**
+ * @return A cleared matrix of the requested dimensions
+ */
+- (ZXBitMatrix *)matrixWithWidth:(int)width height:(int)height;
+
+/**
+ * @return An array of at least length bytes with undefined contents
+ */
+- (ZXByteArray *)luminancesWithLength:(int)length;
+
+/**
+ * @return A histogram array of the requested length, cleared to zero
+ */
+- (ZXIntArray *)bucketsWithLength:(int)length;
+
+@end
@@ -0,0 +1,99 @@
+/*
+ * Copyright 2014 ZXing authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "ZXBinarizerContext.h"
+#import "ZXBitMatrix.h"
+#import "ZXByteArray.h"
+#import "ZXIntArray.h"
+
+@interface ZXBinarizerContext ()
+
+@property (nonatomic, assign) int *blackPoints;
+@property (nonatomic, assign) int blackPointsCount;
+@property (nonatomic, assign) int *scratch;
+@property (nonatomic, assign) int scratchCount;
+@property (nonatomic, strong) ZXBitMatrix *matrix;
+@property (nonatomic, strong) ZXByteArray *luminances;
+@property (nonatomic, strong) ZXIntArray *buckets;
+
+@end
+
+@implementation ZXBinarizerContext
+
++ (id)context {
+  return [[self alloc] init];
+}
+
+- (void)dealloc {
+  if (_blackPoints != NULL) {
+    free(_blackPoints);
+    _blackPoints = NULL;
+  }
+  if (_scratch != NULL) {
+    free(_scratch);
+    _scratch = NULL;
+  }
+}
+
+- (int *)blackPointsWithCount:(int)count {
+  if (self.blackPointsCount < count) {
+    free(self.blackPoints);
+    self.blackPoints = (int *)malloc(count * sizeof(int));
+    self.blackPointsCount = count;
+    _allocationCount++;
+  }
+  return self.blackPoints;
+}
+
+- (int *)scratchWithCount:(int)count {
+  if (self.scratchCount < count) {
+    free(self.scratch);
+    self.scratch = (int *)malloc(count * sizeof(int));
+    self.scratchCount = count;
+    _allocationCount++;
+  }
+  return self.scratch;
+}
+
+- (ZXBitMatrix *)matrixWithWidth:(int)width height:(int)height {
+  if (self.matrix != nil && self.matrix.width == width && self.matrix.height == height) {
+    [self.matrix clear];
+  } else {
+    self.matrix = [[ZXBitMatrix alloc] initWithWidth:width height:height];
+    _allocationCount++;
+  }
+  return self.matrix;
+}
+
+- (ZXByteArray *)luminancesWithLength:(int)length {
+  if (self.luminances == nil || self.luminances.length < length) {
+    self.luminances = [[ZXByteArray alloc] initWithLength:length];
+    _allocationCount++;
+  }
+  return self.luminances;
+}
+
+- (ZXIntArray *)bucketsWithLength:(int)length {
+  if (self.buckets != nil && self.buckets.length == length) {
+    [self.buckets clear];
+  } else {
+    self.buckets = [[ZXIntArray alloc] initWithLength:length];
+    _allocationCount++;
+  }
+  return self.buckets;
+}
+
+@end
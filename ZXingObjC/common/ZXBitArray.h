@@ -62,6 +62,23 @@
 
 - (int)nextUnset:(int)from;
 
+/**
+ * Returns where each run of equal bits starts, followed by size, so that run i covers bits
+ * runs[i] up to but excluding runs[i + 1]. Runs alternate in value starting with the value of bit 0.
+ * The runs are found a word at a time on first use and kept until the array is changed through
+ * one of its methods; writes made directly to bits do not discard them.
+ *
+ * @param count set to the number of runs, so that count + 1 offsets are returned
+ * @return run starts, owned by this array
+ */
+- (const int32_t *)runStartsWithCount:(int *)count;
+
+/**
+ * @param i bit to look up, which must be less than size
+ * @return index into runStartsWithCount: of the run containing bit i
+ */
+- (int)runIndexAt:(int)i;
+
 /**
  * Sets a block of 32 bits, starting at bit i.
  *
@@ -23,6 +23,9 @@
 @property (nonatomic, assign) int32_t *bits;
 @property (nonatomic, assign) int bitsLength;
 @property (nonatomic, assign) int size;
+@property (nonatomic, assign) int32_t *runStarts;
+@property (nonatomic, assign) int runStartsLength;
+@property (nonatomic, assign) int runCount;
 
 @end
 
@@ -65,6 +68,10 @@
     free(_bits);
     _bits = NULL;
   }
+  if (_runStarts != NULL) {
+    free(_runStarts);
+    _runStarts = NULL;
+  }
 }
 
 - (int)sizeInBytes {
@@ -87,10 +94,12 @@
 
 - (void)set:(int)i {
   _bits[i / 32] |= 1 << (i & 0x1F);
+  _runCount = 0;
 }
 
 - (void)flip:(int)i {
   _bits[i / 32] ^= 1 << (i & 0x1F);
+  _runCount = 0;
 }
 
 - (int)nextSet:(int)from {
@@ -129,8 +138,73 @@
   return result > self.size ? self.size : result;
 }
 
+- (const int32_t *)runStartsWithCount:(int *)count {
+  if (self.runCount == 0) {
+    [self findRuns];
+  }
+  *count = self.runCount;
+  return self.runStarts;
+}
+
+- (int)runIndexAt:(int)i {
+  int count;
+  const int32_t *runStarts = [self runStartsWithCount:&count];
+  int low = 0;
+  int high = count - 1;
+  while (low < high) {
+    int mid = (low + high + 1) >> 1;
+    if (runStarts[mid] <= i) {
+      low = mid;
+    } else {
+      high = mid - 1;
+    }
+  }
+  return low;
+}
+
+/**
+ * Finds the run starts in one pass over the words. A bit starts a run when it differs from the
+ * bit before it, so each word is compared against itself shifted by one, carrying the top bit of
+ * the previous word, and the differences are read off by counting trailing zeros.
+ */
+- (void)findRuns {
+  int size = self.size;
+  if (self.runStarts == NULL || self.runStartsLength < size + 2) {
+    self.runStarts = realloc(self.runStarts, (size + 2) * sizeof(int32_t));
+    self.runStartsLength = size + 2;
+  }
+  int32_t *runStarts = self.runStarts;
+  runStarts[0] = 0;
+  if (size == 0) {
+    runStarts[1] = 0;
+    return;
+  }
+  int count = 1;
+
+  int words = (size + 31) / 32;
+  uint32_t previous = (uint32_t)(_bits[0] & 1);
+  for (int i = 0; i < words; i++) {
+    uint32_t word = (uint32_t)_bits[i];
+    uint32_t changes = word ^ ((word << 1) | previous);
+    if (i == 0) {
+      changes &= ~1u;
+    }
+    if (i == words - 1 && (size & 0x1F) != 0) {
+      changes &= (1u << (size & 0x1F)) - 1;
+    }
+    while (changes != 0) {
+      runStarts[count++] = (i << 5) + __builtin_ctz(changes);
+      changes &= changes - 1;
+    }
+    previous = word >> 31;
+  }
+  runStarts[count] = size;
+  self.runCount = count;
+}
+
 - (void)setBulk:(int)i newBits:(int32_t)newBits {
   _bits[i / 32] = newBits;
+  _runCount = 0;
 }
 
 - (void)setRange:(int)start end:(int)end {
@@ -140,6 +214,7 @@
   if (end == start) {
     return;
   }
+  _runCount = 0;
   end--; // will be easier to treat this as the last actually set bit -- inclusive
   int firstInt = start / 32;
   int lastInt = end / 32;
@@ -160,6 +235,7 @@
 }
 
 - (void)clear {
+  _runCount = 0;
   memset(self.bits, 0, self.bitsLength * sizeof(int32_t));
 }
 
@@ -197,6 +273,7 @@
 }
 
 - (void)appendBit:(BOOL)bit {
+  _runCount = 0;
   [self ensureCapacity:self.size + 1];
   if (bit) {
     self.bits[self.size / 32] |= 1 << (self.size & 0x1F);
@@ -232,6 +309,7 @@
                                  userInfo:nil];
   }
 
+  _runCount = 0;
   for (int i = 0; i < self.bitsLength; i++) {
     // The last byte could be incomplete (i.e. not have 8 bits in
     // it) but there is no problem since 0 XOR 0 == 0.
@@ -306,6 +384,7 @@
     free(self.bits);
   }
   self.bits = newBits;
+  _runCount = 0;
 }
 
 - (NSString *)description {
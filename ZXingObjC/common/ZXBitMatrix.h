@@ -16,6 +16,14 @@
 
 @class ZXBitArray, ZXIntArray;
 
+/**
+ * Reads bit (x, y) straight from the bits of a ZXBitMatrix, avoiding a message send per pixel in
+ * tight loops. Callers fetch bits and rowSize from the matrix once and must stay within bounds.
+ */
+static inline BOOL ZXBitMatrixGetBit(const int32_t *bits, int rowSize, int x, int y) {
+  return ((bits[y * rowSize + (x >> 5)] >> (x & 0x1f)) & 1) != 0;
+}
+
 /**
  * Represents a 2D matrix of bits. In function arguments below, and throughout the common
  * module, x is the column position, and y is the row position. The ordering is always x, y.
@@ -40,6 +48,11 @@
  */
 @property (nonatomic, assign, readonly) int height;
 
+/**
+ * @return The number of 32-bit words in each row of bits
+ */
+@property (nonatomic, assign, readonly) int rowSize;
+
 @property (nonatomic, assign, readonly) int32_t *bits;
 
 // A helper to construct a square matrix.
@@ -60,6 +73,40 @@
  */
 - (BOOL)getX:(int)x y:(int)y;
 
+/**
+ * Counts the consecutive pixels equal to value, starting at (x, y) inclusive and stepping by
+ * (dx, dy), stopping at the edge of the matrix or after maxCount pixels. Horizontal runs are
+ * found by scanning whole words at a time.
+ *
+ * Adding the result times (dx, dy) to (x, y) gives the next transition in that direction.
+ *
+ * @param x The horizontal component of the start (i.e. which column)
+ * @param y The vertical component of the start (i.e. which row)
+ * @param dx The horizontal step, one of -1, 0 or 1
+ * @param dy The vertical step, one of -1, 0 or 1
+ * @param value The color to count, where true means black
+ * @param maxCount The largest count to return
+ * @return The length of the run, 0 if the start is outside the matrix or of the other color
+ */
+- (int)runLengthFromX:(int)x y:(int)y dx:(int)dx dy:(int)dy value:(BOOL)value maxCount:(int)maxCount;
+
+/**
+ * Counts the number of black/white transitions between two points, walking the line between
+ * them with Bresenham's algorithm. The end point is not included.
+ */
+- (int)transitionsFromX:(int)fromX fromY:(int)fromY toX:(int)toX toY:(int)toY;
+
+/**
+ * Returns this matrix transposed, so that column x of this matrix is row x of the result and
+ * vertical runs can be counted with the same word scans as rows. It is built on first use with a
+ * 32x32 bit transpose and cached until this matrix is changed through one of its mutators;
+ * writes made directly to bits do not discard it. The cache is not locked, so threads must not
+ * call this on the same matrix at once.
+ *
+ * @return The transposed matrix, owned by this matrix and not to be modified
+ */
+- (ZXBitMatrix *)transposedMatrix;
+
 /**
  * Sets the given bit to true.
  *
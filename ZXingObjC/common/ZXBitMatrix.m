@@ -20,11 +20,61 @@
 
 @interface ZXBitMatrix ()
 
-@property (nonatomic, assign, readonly) int rowSize;
 @property (nonatomic, assign, readonly) int bitsSize;
+@property (nonatomic, strong) ZXBitMatrix *transposed;
 
 @end
 
+/**
+ * Counts the pixels equal to value in one row of bits, starting at x and stepping by step (1 or -1),
+ * up to limit pixels. limit must not run past either end of the row. Each word is compared at once
+ * and the first differing pixel is located by counting zeros.
+ */
+static inline int ZXBitMatrixRowRunLength(const int32_t *row, int x, int step, BOOL value, int limit) {
+  uint32_t invert = value ? 0xFFFFFFFF : 0;
+  int word = x >> 5;
+  int run;
+  if (step > 0) {
+    // Bits set in differ are pixels of the other color; ignore the ones before x.
+    uint32_t differ = ((uint32_t)row[word] ^ invert) & (0xFFFFFFFF << (x & 0x1f));
+    while (differ == 0) {
+      word++;
+      if ((word << 5) - x >= limit) {
+        return limit;
+      }
+      differ = (uint32_t)row[word] ^ invert;
+    }
+    run = (word << 5) + __builtin_ctz(differ) - x;
+  } else {
+    // Ignore the pixels after x.
+    uint32_t differ = ((uint32_t)row[word] ^ invert) & (0xFFFFFFFF >> (31 - (x & 0x1f)));
+    while (differ == 0) {
+      if (x - (word << 5) + 1 >= limit) {
+        return limit;
+      }
+      word--;
+      differ = (uint32_t)row[word] ^ invert;
+    }
+    run = x - ((word << 5) + 31 - __builtin_clz(differ));
+  }
+  return run < limit ? run : limit;
+}
+
+/**
+ * Transposes a 32x32 block of bits in place, where bit c of word r is swapped with bit r of word c.
+ * Works by swapping ever smaller off-diagonal blocks: 16x16, then 8x8, down to single bits.
+ */
+static inline void ZXBitMatrixTranspose32(uint32_t block[32]) {
+  uint32_t mask = 0x0000FFFF;
+  for (int j = 16; j != 0; j >>= 1, mask ^= mask << j) {
+    for (int k = 0; k < 32; k = (k + j + 1) & ~j) {
+      uint32_t t = ((block[k] >> j) ^ block[k + j]) & mask;
+      block[k + j] ^= t;
+      block[k] ^= t << j;
+    }
+  }
+}
+
 @implementation ZXBitMatrix
 
 + (ZXBitMatrix *)bitMatrixWithDimension:(int)dimension {
@@ -82,17 +132,132 @@
   return ((self.bits[offset] >> (x & 0x1f)) & 1) != 0;
 }
 
+- (int)runLengthFromX:(int)x y:(int)y dx:(int)dx dy:(int)dy value:(BOOL)value maxCount:(int)maxCount {
+  if (x < 0 || y < 0 || x >= self.width || y >= self.height) {
+    return 0;
+  }
+  int limit = maxCount;
+  if (dx > 0 && self.width - x < limit) {
+    limit = self.width - x;
+  } else if (dx < 0 && x + 1 < limit) {
+    limit = x + 1;
+  }
+  if (dy > 0 && self.height - y < limit) {
+    limit = self.height - y;
+  } else if (dy < 0 && y + 1 < limit) {
+    limit = y + 1;
+  }
+  if (limit <= 0) {
+    return 0;
+  }
+
+  int32_t *bits = self.bits;
+  int rowSize = self.rowSize;
+  if (dy == 0 && dx != 0) {
+    return ZXBitMatrixRowRunLength(bits + y * rowSize, x, dx, value, limit);
+  }
+
+  int count = 0;
+  while (count < limit && ZXBitMatrixGetBit(bits, rowSize, x, y) == value) {
+    count++;
+    x += dx;
+    y += dy;
+  }
+  return count;
+}
+
+- (int)transitionsFromX:(int)fromX fromY:(int)fromY toX:(int)toX toY:(int)toY {
+  BOOL steep = abs(toY - fromY) > abs(toX - fromX);
+  if (steep) {
+    int temp = fromX;
+    fromX = fromY;
+    fromY = temp;
+    temp = toX;
+    toX = toY;
+    toY = temp;
+  }
+
+  int32_t *bits = self.bits;
+  int rowSize = self.rowSize;
+  int dx = abs(toX - fromX);
+  int dy = abs(toY - fromY);
+  int error = -dx >> 1;
+  int ystep = fromY < toY ? 1 : -1;
+  int xstep = fromX < toX ? 1 : -1;
+  int transitions = 0;
+  BOOL inBlack = ZXBitMatrixGetBit(bits, rowSize, steep ? fromY : fromX, steep ? fromX : fromY);
+  for (int x = fromX, y = fromY; x != toX; x += xstep) {
+    BOOL isBlack = ZXBitMatrixGetBit(bits, rowSize, steep ? y : x, steep ? x : y);
+    if (isBlack != inBlack) {
+      transitions++;
+      inBlack = isBlack;
+    }
+    error += dy;
+    if (error > 0) {
+      if (y == toY) {
+        break;
+      }
+      y += ystep;
+      error -= dx;
+    }
+  }
+  return transitions;
+}
+
+- (ZXBitMatrix *)transposedMatrix {
+  if (self.transposed) {
+    return self.transposed;
+  }
+
+  ZXBitMatrix *transposed = [[ZXBitMatrix alloc] initWithWidth:self.height height:self.width];
+  int32_t *bits = self.bits;
+  int32_t *transposedBits = transposed.bits;
+  int rowSize = self.rowSize;
+  int transposedRowSize = transposed.rowSize;
+  uint32_t block[32];
+  for (int blockY = 0; blockY < transposedRowSize; blockY++) {
+    int top = blockY << 5;
+    int rows = MIN(32, self.height - top);
+    for (int blockX = 0; blockX < rowSize; blockX++) {
+      for (int r = 0; r < rows; r++) {
+        block[r] = (uint32_t)bits[(top + r) * rowSize + blockX];
+      }
+      for (int r = rows; r < 32; r++) {
+        block[r] = 0;
+      }
+      ZXBitMatrixTranspose32(block);
+
+      // Bits past the width of this matrix have no row to go to
+      int left = blockX << 5;
+      int columns = MIN(32, self.width - left);
+      for (int c = 0; c < columns; c++) {
+        transposedBits[(left + c) * transposedRowSize + blockY] = (int32_t)block[c];
+      }
+    }
+  }
+
+  self.transposed = transposed;
+  return transposed;
+}
+
 - (void)setX:(int)x y:(int)y {
   NSInteger offset = y * self.rowSize + (x >> 5);
   self.bits[offset] |= 1 << (x & 0x1f);
+  if (_transposed) {
+    _transposed = nil;
+  }
 }
 
 - (void)flipX:(int)x y:(int)y {
   NSUInteger offset = y * self.rowSize + (x >> 5);
   self.bits[offset] ^= 1 << (x & 0x1f);
+  if (_transposed) {
+    _transposed = nil;
+  }
 }
 
 - (void)clear {
+  self.transposed = nil;
   NSInteger max = self.bitsSize;
   memset(self.bits, 0, max * sizeof(int32_t));
 }
@@ -110,6 +275,7 @@
                                    reason:@"The region must fit inside the matrix"
                                  userInfo:nil];
   }
+  self.transposed = nil;
   for (NSUInteger y = top; y < bottom; y++) {
     NSUInteger offset = y * self.rowSize;
     for (NSInteger x = left; x < right; x++) {
@@ -133,6 +299,7 @@
 }
 
 - (void)setRowAtY:(int)y row:(ZXBitArray *)row {
+  self.transposed = nil;
   for (NSUInteger i = 0; i < self.rowSize; i++) {
     self.bits[(y * self.rowSize) + i] = row.bits[i];
   }
@@ -22,4 +22,16 @@
 - (id)initWithLength:(unsigned int)length;
 - (id)initWithBytes:(int8_t)byte1, ...;
 
+/**
+ * Wraps an existing buffer without copying it. The buffer must stay valid for the lifetime of
+ * the receiver. When the receiver is deallocated the deallocator is invoked with the wrapped
+ * bytes, which lets callers release or recycle the memory; pass nil if the caller frees the
+ * buffer itself.
+ *
+ * @param bytes The buffer to wrap
+ * @param length The number of bytes in the buffer
+ * @param deallocator An optional block invoked once when the receiver no longer needs the bytes
+ */
+- (id)initWithBytesNoCopy:(int8_t *)bytes length:(unsigned int)length deallocator:(void (^)(int8_t *bytes, unsigned int length))deallocator;
+
 @end
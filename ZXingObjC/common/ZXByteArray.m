@@ -16,12 +16,20 @@
 
 #import "ZXByteArray.h"
 
+@interface ZXByteArray ()
+
+@property (nonatomic, copy, readonly) void (^deallocator)(int8_t *bytes, unsigned int length);
+@property (nonatomic, assign, readonly) BOOL freeWhenDone;
+
+@end
+
 @implementation ZXByteArray
 
 - (id)initWithLength:(unsigned int)length {
   if (self = [super init]) {
     _array = (int8_t *)calloc(length, sizeof(BOOL));
     _length = length;
+    _freeWhenDone = YES;
   }
 
   return self;
@@ -49,8 +57,21 @@
   return self;
 }
 
+- (id)initWithBytesNoCopy:(int8_t *)bytes length:(unsigned int)length deallocator:(void (^)(int8_t *bytes, unsigned int length))deallocator {
+  if (self = [super init]) {
+    _array = bytes;
+    _length = length;
+    _deallocator = [deallocator copy];
+    _freeWhenDone = NO;
+  }
+
+  return self;
+}
+
 - (void)dealloc {
-  if (_array) {
+  if (_deallocator) {
+    _deallocator(_array, _length);
+  } else if (_array && _freeWhenDone) {
     free(_array);
   }
 }
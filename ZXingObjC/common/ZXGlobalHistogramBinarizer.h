@@ -16,7 +16,7 @@
 
 #import "ZXBinarizer.h"
 
-@class ZXBitArray, ZXBitMatrix, ZXLuminanceSource;
+@class ZXBinarizerContext, ZXBitArray, ZXBitMatrix, ZXLuminanceSource;
 
 /**
  * This Binarizer implementation uses the old ZXing global histogram approach. It is suitable
@@ -28,6 +28,12 @@
  */
 @interface ZXGlobalHistogramBinarizer : ZXBinarizer
 
+/**
+ * An optional context providing the scratch buffers and output matrix, so they can be reused
+ * across frames. It is not passed on to binarizers created for cropped or rotated sources.
+ */
+@property (nonatomic, strong) ZXBinarizerContext *context;
+
 // Applies simple sharpening to the row data to improve performance of the 1D Readers.
 - (ZXBitArray *)blackRow:(int)y row:(ZXBitArray *)row error:(NSError **)error;
 
@@ -15,6 +15,7 @@
  */
 
 #import "ZXGlobalHistogramBinarizer.h"
+#import "ZXBinarizerContext.h"
 #import "ZXBitArray.h"
 #import "ZXBitMatrix.h"
 #import "ZXByteArray.h"
@@ -54,10 +55,11 @@ const int ZX_LUMINANCE_BUCKETS = 1 << ZX_LUMINANCE_BITS;
   }
 
   [self initArrays:width];
-  ZXByteArray *localLuminances = [source rowAtY:y row:self.luminances];
+  int invertMask;
+  int8_t *localLuminances = [self luminanceRow:y invertMask:&invertMask];
   ZXIntArray *localBuckets = self.buckets;
   for (int x = 0; x < width; x++) {
-    int pixel = localLuminances.array[x] & 0xff;
+    int pixel = (localLuminances[x] & 0xff) ^ invertMask;
     localBuckets.array[pixel >> ZX_LUMINANCE_SHIFT]++;
   }
   int blackPoint = [self estimateBlackPoint:localBuckets];
@@ -66,10 +68,10 @@ const int ZX_LUMINANCE_BUCKETS = 1 << ZX_LUMINANCE_BITS;
     return nil;
   }
 
-  int left = localLuminances.array[0] & 0xff;
-  int center = localLuminances.array[1] & 0xff;
+  int left = (localLuminances[0] & 0xff) ^ invertMask;
+  int center = (localLuminances[1] & 0xff) ^ invertMask;
   for (int x = 1; x < width - 1; x++) {
-    int right = localLuminances.array[x + 1] & 0xff;
+    int right = (localLuminances[x + 1] & 0xff) ^ invertMask;
     // A simple -1 4 -1 box filter with a weight of 2.
     int luminance = ((center << 2) - left - right) >> 1;
     if (luminance < blackPoint) {
@@ -86,7 +88,8 @@ const int ZX_LUMINANCE_BUCKETS = 1 << ZX_LUMINANCE_BITS;
   ZXLuminanceSource *source = self.luminanceSource;
   int width = source.width;
   int height = source.height;
-  ZXBitMatrix *matrix = [[ZXBitMatrix alloc] initWithWidth:width height:height];
+  ZXBitMatrix *matrix = self.context != nil ? [self.context matrixWithWidth:width height:height] :
+    [[ZXBitMatrix alloc] initWithWidth:width height:height];
 
   // Quickly calculates the histogram by sampling four rows from the image. This proved to be
   // more robust on the blackbox tests than sampling a diagonal as we used to do.
@@ -98,10 +101,11 @@ const int ZX_LUMINANCE_BUCKETS = 1 << ZX_LUMINANCE_BITS;
   ZXIntArray *localBuckets = self.buckets;
   for (int y = 1; y < 5; y++) {
     int row = height * y / 5;
-    ZXByteArray *localLuminances = [source rowAtY:row row:self.luminances];
+    int invertMask;
+    int8_t *localLuminances = [self luminanceRow:row invertMask:&invertMask];
     int right = (width << 2) / 5;
     for (int x = width / 5; x < right; x++) {
-      int pixel = localLuminances.array[x] & 0xff;
+      int pixel = (localLuminances[x] & 0xff) ^ invertMask;
       localBuckets.array[pixel >> ZX_LUMINANCE_SHIFT]++;
     }
   }
@@ -111,11 +115,22 @@ const int ZX_LUMINANCE_BUCKETS = 1 << ZX_LUMINANCE_BITS;
     return nil;
   }
 
-  ZXByteArray *localLuminances = source.matrix;
+  // Read the luminances in place if the source allows it, to avoid copying the whole image.
+  int stride;
+  BOOL inverted;
+  int8_t *localLuminances = [source luminancesWithRowStride:&stride inverted:&inverted];
+  ZXByteArray *localMatrix NS_VALID_UNTIL_END_OF_SCOPE = nil;
+  if (localLuminances == NULL) {
+    localMatrix = source.matrix;
+    localLuminances = localMatrix.array;
+    stride = width;
+    inverted = NO;
+  }
+  int invertMask = inverted ? 0xff : 0;
   for (int y = 0; y < height; y++) {
-    int offset = y * width;
+    int offset = y * stride;
     for (int x = 0; x < width; x++) {
-      int pixel = localLuminances.array[offset + x] & 0xff;
+      int pixel = (localLuminances[offset + x] & 0xff) ^ invertMask;
       if (pixel < blackPoint) {
         [matrix setX:x y:y];
       }
@@ -130,6 +145,12 @@ const int ZX_LUMINANCE_BUCKETS = 1 << ZX_LUMINANCE_BITS;
 }
 
 - (void)initArrays:(int)luminanceSize {
+  if (self.context != nil) {
+    self.luminances = [self.context luminancesWithLength:luminanceSize];
+    self.buckets = [self.context bucketsWithLength:ZX_LUMINANCE_BUCKETS];
+    return;
+  }
+
   if (self.luminances.length < luminanceSize) {
     self.luminances = [[ZXByteArray alloc] initWithLength:luminanceSize];
   }
@@ -139,6 +160,24 @@ const int ZX_LUMINANCE_BUCKETS = 1 << ZX_LUMINANCE_BITS;
   }
 }
 
+/**
+ * Returns row y of the luminance source, read in place when the source supports it and copied
+ * into the luminances scratch array otherwise. initArrays: must have been called first.
+ */
+- (int8_t *)luminanceRow:(int)y invertMask:(int *)invertMask {
+  ZXLuminanceSource *source = self.luminanceSource;
+  int stride;
+  BOOL inverted;
+  int8_t *luminances = [source luminancesWithRowStride:&stride inverted:&inverted];
+  if (luminances != NULL && y >= 0 && y < source.height) {
+    *invertMask = inverted ? 0xff : 0;
+    return luminances + y * stride;
+  }
+  self.luminances = [source rowAtY:y row:self.luminances];
+  *invertMask = 0;
+  return self.luminances.array;
+}
+
 - (int)estimateBlackPoint:(ZXIntArray *)buckets {
   // Find the tallest peak in the histogram.
   int numBuckets = buckets.length;
@@ -36,6 +36,9 @@
  * in the whole lifetime of the JVM. For instance, an Android activity can swap in
  * an implementation that takes advantage of native platform libraries.
  *
+ * Set it before decoding starts. The sampler is used by every thread that decodes, so it must
+ * not keep state between calls.
+ *
  * @param newGridSampler The platform-specific object to install.
  */
 + (void)setGridSampler:(ZXGridSampler *)newGridSampler;
@@ -29,9 +29,12 @@ static ZXGridSampler *gridSampler = nil;
 }
 
 + (ZXGridSampler *)instance {
-  if (!gridSampler) {
-    gridSampler = [[ZXDefaultGridSampler alloc] init];
-  }
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    if (!gridSampler) {
+      gridSampler = [[ZXDefaultGridSampler alloc] init];
+    }
+  });
 
   return gridSampler;
 }
@@ -35,4 +35,11 @@
  */
 @interface ZXHybridBinarizer : ZXGlobalHistogramBinarizer
 
+/**
+ * The number of horizontal bands the image is split into when binarizing, each processed
+ * concurrently on the global dispatch queue. The result is identical to the serial computation.
+ * Defaults to 1, which binarizes on the calling thread.
+ */
+@property (nonatomic, assign) int concurrency;
+
 @end
@@ -14,10 +14,17 @@
  * limitations under the License.
  */
 
+#import "ZXBinarizerContext.h"
 #import "ZXByteArray.h"
 #import "ZXHybridBinarizer.h"
 #import "ZXIntArray.h"
 
+#if defined(__SSE2__)
+#import <emmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#import <arm_neon.h>
+#endif
+
 // This class uses 5x5 blocks to compute local luminance, where each block is 8x8 pixels.
 // So this is the smallest dimension in each axis we can accept.
 const int ZX_BLOCK_SIZE_POWER = 3;
@@ -26,6 +33,152 @@ const int ZX_BLOCK_SIZE_MASK = ZX_BLOCK_SIZE - 1;   // ...0011...11
 const int ZX_MINIMUM_DIMENSION = ZX_BLOCK_SIZE * 5;
 const int ZX_MIN_DYNAMIC_RANGE = 24;
 
+static inline int ZXHybridBinarizerCap(int value, int min, int max) {
+  return value < min ? min : value > max ? max : value;
+}
+
+/**
+ * Computes the sum, minimum and maximum of the 8x8 block of pixels starting at luminances.
+ * The kernel is picked at compile time: SSE2 on x86, NEON on ARM, and plain C otherwise.
+ */
+static inline void ZXHybridBinarizerBlockStatistics(const int8_t *luminances, int stride, int invertMask,
+                                                     int *sum, int *min, int *max) {
+#if defined(__SSE2__)
+  __m128i invert = _mm_set1_epi8((char)invertMask);
+  __m128i zero = _mm_setzero_si128();
+  __m128i sums = zero;
+  __m128i mins = _mm_set1_epi8((char)0xFF);
+  __m128i maxs = zero;
+  // Two 8 pixel rows per 128 bit register.
+  for (int yy = 0; yy < ZX_BLOCK_SIZE; yy += 2) {
+    __m128i lo = _mm_loadl_epi64((const __m128i *)(luminances + yy * stride));
+    __m128i hi = _mm_loadl_epi64((const __m128i *)(luminances + (yy + 1) * stride));
+    __m128i pixels = _mm_xor_si128(_mm_unpacklo_epi64(lo, hi), invert);
+    sums = _mm_add_epi64(sums, _mm_sad_epu8(pixels, zero));
+    mins = _mm_min_epu8(mins, pixels);
+    maxs = _mm_max_epu8(maxs, pixels);
+  }
+  sums = _mm_add_epi64(sums, _mm_srli_si128(sums, 8));
+  mins = _mm_min_epu8(mins, _mm_srli_si128(mins, 8));
+  mins = _mm_min_epu8(mins, _mm_srli_si128(mins, 4));
+  mins = _mm_min_epu8(mins, _mm_srli_si128(mins, 2));
+  mins = _mm_min_epu8(mins, _mm_srli_si128(mins, 1));
+  maxs = _mm_max_epu8(maxs, _mm_srli_si128(maxs, 8));
+  maxs = _mm_max_epu8(maxs, _mm_srli_si128(maxs, 4));
+  maxs = _mm_max_epu8(maxs, _mm_srli_si128(maxs, 2));
+  maxs = _mm_max_epu8(maxs, _mm_srli_si128(maxs, 1));
+  *sum = _mm_cvtsi128_si32(sums);
+  *min = _mm_cvtsi128_si32(mins) & 0xFF;
+  *max = _mm_cvtsi128_si32(maxs) & 0xFF;
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+  uint8x8_t invert = vdup_n_u8((uint8_t)invertMask);
+  uint16x8_t sums = vdupq_n_u16(0);
+  uint8x8_t mins = vdup_n_u8(0xFF);
+  uint8x8_t maxs = vdup_n_u8(0);
+  for (int yy = 0; yy < ZX_BLOCK_SIZE; yy++) {
+    uint8x8_t pixels = veor_u8(vld1_u8((const uint8_t *)(luminances + yy * stride)), invert);
+    sums = vaddw_u8(sums, pixels);
+    mins = vmin_u8(mins, pixels);
+    maxs = vmax_u8(maxs, pixels);
+  }
+  uint64x2_t sums64 = vpaddlq_u32(vpaddlq_u16(sums));
+  mins = vpmin_u8(mins, mins);
+  mins = vpmin_u8(mins, mins);
+  mins = vpmin_u8(mins, mins);
+  maxs = vpmax_u8(maxs, maxs);
+  maxs = vpmax_u8(maxs, maxs);
+  maxs = vpmax_u8(maxs, maxs);
+  *sum = (int)(vgetq_lane_u64(sums64, 0) + vgetq_lane_u64(sums64, 1));
+  *min = vget_lane_u8(mins, 0);
+  *max = vget_lane_u8(maxs, 0);
+#else
+  int blockSum = 0;
+  int blockMin = 0xFF;
+  int blockMax = 0;
+  for (int yy = 0, offset = 0; yy < ZX_BLOCK_SIZE; yy++, offset += stride) {
+    for (int xx = 0; xx < ZX_BLOCK_SIZE; xx++) {
+      int pixel = (luminances[offset + xx] & 0xFF) ^ invertMask;
+      blockSum += pixel;
+      if (pixel < blockMin) {
+        blockMin = pixel;
+      }
+      if (pixel > blockMax) {
+        blockMax = pixel;
+      }
+    }
+  }
+  *sum = blockSum;
+  *min = blockMin;
+  *max = blockMax;
+#endif
+}
+
+/**
+ * Returns a bit mask of the 8 pixels starting at luminances which are at or below the threshold,
+ * with the first pixel in the least significant bit.
+ */
+static inline uint32_t ZXHybridBinarizerThresholdMask(const int8_t *luminances, int threshold, int invertMask) {
+#if defined(__SSE2__)
+  __m128i pixels = _mm_xor_si128(_mm_loadl_epi64((const __m128i *)luminances), _mm_set1_epi8((char)invertMask));
+  // Unsigned pixel <= threshold is equivalent to min(pixel, threshold) == pixel.
+  __m128i below = _mm_cmpeq_epi8(_mm_min_epu8(pixels, _mm_set1_epi8((char)threshold)), pixels);
+  return _mm_movemask_epi8(below) & 0xFF;
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+  static const uint8_t bitValues[8] = {1, 2, 4, 8, 16, 32, 64, 128};
+  uint8x8_t pixels = veor_u8(vld1_u8((const uint8_t *)luminances), vdup_n_u8((uint8_t)invertMask));
+  uint8x8_t below = vand_u8(vcle_u8(pixels, vdup_n_u8((uint8_t)threshold)), vld1_u8(bitValues));
+  below = vpadd_u8(below, below);
+  below = vpadd_u8(below, below);
+  below = vpadd_u8(below, below);
+  return vget_lane_u8(below, 0);
+#else
+  uint32_t mask = 0;
+  for (int x = 0; x < ZX_BLOCK_SIZE; x++) {
+    // Comparison needs to be <= so that black == 0 pixels are black even if the threshold is 0
+    if (((luminances[x] & 0xFF) ^ invertMask) <= threshold) {
+      mask |= 1 << x;
+    }
+  }
+  return mask;
+#endif
+}
+
+/**
+ * Applies a single threshold to a block of pixels, writing eight pixels of each row at once
+ * straight into the matrix bits.
+ */
+static inline void ZXHybridBinarizerThresholdBlock(const int8_t *luminances, int xoffset, int yoffset, int threshold,
+                                                   int stride, int invertMask, int32_t *bits, int rowSize) {
+  int shift = xoffset & 0x1f;
+  const int8_t *pixels = luminances + yoffset * stride + xoffset;
+  int32_t *word = bits + yoffset * rowSize + (xoffset >> 5);
+  for (int y = 0; y < ZX_BLOCK_SIZE; y++, pixels += stride, word += rowSize) {
+    uint32_t mask = ZXHybridBinarizerThresholdMask(pixels, threshold, invertMask);
+    if (mask != 0) {
+      word[0] |= (int32_t)(mask << shift);
+      // The last block of a row is shifted left to fit and may straddle two words.
+      if (shift > 32 - ZX_BLOCK_SIZE) {
+        word[1] |= (int32_t)(mask >> (32 - shift));
+      }
+    }
+  }
+}
+
+/**
+ * Splits the rows [0, count) into contiguous bands and runs block on each of them, concurrently on
+ * the global dispatch queue if more than one band is requested.
+ */
+static void ZXHybridBinarizerForEachBand(int concurrency, int count, void (^block)(int start, int end)) {
+  int bands = concurrency < count ? concurrency : count;
+  if (bands <= 1) {
+    block(0, count);
+    return;
+  }
+  dispatch_apply(bands, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t band) {
+    block((int)(count * band / bands), (int)(count * (band + 1) / bands));
+  });
+}
+
 @interface ZXHybridBinarizer ()
 
 @property (nonatomic, strong) ZXBitMatrix *matrix;
@@ -34,6 +187,14 @@ const int ZX_MIN_DYNAMIC_RANGE = 24;
 
 @implementation ZXHybridBinarizer
 
+- (id)initWithSource:(ZXLuminanceSource *)source {
+  if (self = [super initWithSource:source]) {
+    _concurrency = 1;
+  }
+
+  return self;
+}
+
 /**
  * Calculates the final BitMatrix once for all requests. This could be called once from the
  * constructor instead, but there are some advantages to doing it lazily, such as making
@@ -47,7 +208,18 @@ const int ZX_MIN_DYNAMIC_RANGE = 24;
   int width = source.width;
   int height = source.height;
   if (width >= ZX_MINIMUM_DIMENSION && height >= ZX_MINIMUM_DIMENSION) {
-    ZXByteArray *luminances = source.matrix;
+    // Read the luminances in place if the source allows it, so cropped sources are not copied.
+    int stride;
+    BOOL inverted;
+    int8_t *luminances = [source luminancesWithRowStride:&stride inverted:&inverted];
+    ZXByteArray *luminanceMatrix NS_VALID_UNTIL_END_OF_SCOPE = nil;
+    if (luminances == NULL) {
+      luminanceMatrix = source.matrix;
+      luminances = luminanceMatrix.array;
+      stride = width;
+      inverted = NO;
+    }
+    int invertMask = inverted ? 0xFF : 0;
     int subWidth = width >> ZX_BLOCK_SIZE_POWER;
     if ((width & ZX_BLOCK_SIZE_MASK) != 0) {
       subWidth++;
@@ -56,16 +228,20 @@ const int ZX_MIN_DYNAMIC_RANGE = 24;
     if ((height & ZX_BLOCK_SIZE_MASK) != 0) {
       subHeight++;
     }
-    int **blackPoints = [self calculateBlackPoints:luminances.array subWidth:subWidth subHeight:subHeight width:width height:height];
+    ZXBinarizerContext *context = self.context;
+    int blockCount = subWidth * subHeight;
+    int *blackPoints = context != nil ? [context blackPointsWithCount:blockCount] : (int *)malloc(blockCount * sizeof(int));
+    int *lowContrastMins = context != nil ? [context scratchWithCount:blockCount] : (int *)malloc(blockCount * sizeof(int));
+    [self calculateBlackPoints:luminances stride:stride invertMask:invertMask subWidth:subWidth subHeight:subHeight width:width height:height blackPoints:blackPoints lowContrastMins:lowContrastMins];
 
-    ZXBitMatrix *newMatrix = [[ZXBitMatrix alloc] initWithWidth:width height:height];
-    [self calculateThresholdForBlock:luminances.array subWidth:subWidth subHeight:subHeight width:width height:height blackPoints:blackPoints matrix:newMatrix];
+    ZXBitMatrix *newMatrix = context != nil ? [context matrixWithWidth:width height:height] : [[ZXBitMatrix alloc] initWithWidth:width height:height];
+    [self calculateThresholdForBlock:luminances stride:stride invertMask:invertMask subWidth:subWidth subHeight:subHeight width:width height:height blackPoints:blackPoints matrix:newMatrix];
     self.matrix = newMatrix;
 
-    for (int i = 0; i < subHeight; i++) {
-      free(blackPoints[i]);
+    if (context == nil) {
+      free(blackPoints);
+      free(lowContrastMins);
     }
-    free(blackPoints);
   } else {
     // If the image is too small, fall back to the global histogram approach.
     self.matrix = [super blackMatrixWithError:error];
@@ -74,7 +250,9 @@ const int ZX_MIN_DYNAMIC_RANGE = 24;
 }
 
 - (ZXBinarizer *)createBinarizer:(ZXLuminanceSource *)source {
-  return [[ZXHybridBinarizer alloc] initWithSource:source];
+  ZXHybridBinarizer *binarizer = [[ZXHybridBinarizer alloc] initWithSource:source];
+  binarizer.concurrency = self.concurrency;
+  return binarizer;
 }
 
 /**
@@ -83,141 +261,126 @@ const int ZX_MIN_DYNAMIC_RANGE = 24;
  * on the last pixels in the row/column which are also used in the previous block).
  */
 - (void)calculateThresholdForBlock:(int8_t *)luminances
+                            stride:(int)stride
+                        invertMask:(int)invertMask
                           subWidth:(int)subWidth
                          subHeight:(int)subHeight
                              width:(int)width
                             height:(int)height
-                       blackPoints:(int **)blackPoints
+                       blackPoints:(int *)blackPoints
                             matrix:(ZXBitMatrix *)matrix {
-  for (int y = 0; y < subHeight; y++) {
-    int yoffset = y << ZX_BLOCK_SIZE_POWER;
-    int maxYOffset = height - ZX_BLOCK_SIZE;
-    if (yoffset > maxYOffset) {
-      yoffset = maxYOffset;
+  int32_t *bits = matrix.bits;
+  int rowSize = matrix.rowSize;
+  // The last block row is shifted up to fit and overlaps the pixel rows of the one before it,
+  // so those two rows must always be thresholded by the same band.
+  ZXHybridBinarizerForEachBand(self.concurrency, subHeight - 1, ^(int start, int end) {
+    if (end == subHeight - 1) {
+      end = subHeight;
     }
-    for (int x = 0; x < subWidth; x++) {
-      int xoffset = x << ZX_BLOCK_SIZE_POWER;
-      int maxXOffset = width - ZX_BLOCK_SIZE;
-      if (xoffset > maxXOffset) {
-        xoffset = maxXOffset;
-      }
-      int left = [self cap:x min:2 max:subWidth - 3];
-      int top = [self cap:y min:2 max:subHeight - 3];
-      int sum = 0;
-      for (int z = -2; z <= 2; z++) {
-        int *blackRow = blackPoints[top + z];
-        sum += blackRow[left - 2] + blackRow[left - 1] + blackRow[left] + blackRow[left + 1] + blackRow[left + 2];
+    for (int y = start; y < end; y++) {
+      int yoffset = y << ZX_BLOCK_SIZE_POWER;
+      int maxYOffset = height - ZX_BLOCK_SIZE;
+      if (yoffset > maxYOffset) {
+        yoffset = maxYOffset;
       }
-      int average = sum / 25;
-      [self thresholdBlock:luminances xoffset:xoffset yoffset:yoffset threshold:average stride:width matrix:matrix];
-    }
-  }
-}
-
-- (int)cap:(int)value min:(int)min max:(int)max {
-  return value < min ? min : value > max ? max : value;
-}
-
-/**
- * Applies a single threshold to a block of pixels.
- */
-- (void)thresholdBlock:(int8_t *)luminances
-               xoffset:(int)xoffset
-               yoffset:(int)yoffset
-             threshold:(int)threshold
-                stride:(int)stride
-                matrix:(ZXBitMatrix *)matrix {
-  for (int y = 0, offset = yoffset * stride + xoffset; y < ZX_BLOCK_SIZE; y++, offset += stride) {
-    for (int x = 0; x < ZX_BLOCK_SIZE; x++) {
-      // Comparison needs to be <= so that black == 0 pixels are black even if the threshold is 0
-      if ((luminances[offset + x] & 0xFF) <= threshold) {
-        [matrix setX:xoffset + x y:yoffset + y];
+      for (int x = 0; x < subWidth; x++) {
+        int xoffset = x << ZX_BLOCK_SIZE_POWER;
+        int maxXOffset = width - ZX_BLOCK_SIZE;
+        if (xoffset > maxXOffset) {
+          xoffset = maxXOffset;
+        }
+        int left = ZXHybridBinarizerCap(x, 2, subWidth - 3);
+        int top = ZXHybridBinarizerCap(y, 2, subHeight - 3);
+        int sum = 0;
+        for (int z = -2; z <= 2; z++) {
+          int *blackRow = blackPoints + (top + z) * subWidth;
+          sum += blackRow[left - 2] + blackRow[left - 1] + blackRow[left] + blackRow[left + 1] + blackRow[left + 2];
+        }
+        int average = sum / 25;
+        ZXHybridBinarizerThresholdBlock(luminances, xoffset, yoffset, average, stride, invertMask, bits, rowSize);
       }
     }
-  }
+  });
 }
 
 /**
- * Calculates a single black point for each block of pixels and saves it away.
+ * Calculates a single black point for each block of pixels and saves it away in blackPoints,
+ * a row-major array of subWidth * subHeight values. lowContrastMins is scratch space of the same size.
  * See the following thread for a discussion of this algorithm:
  *  http://groups.google.com/group/zxing/browse_thread/thread/d06efa2c35a7ddc0
  */
-- (int **)calculateBlackPoints:(int8_t *)luminances
-                      subWidth:(int)subWidth
-                     subHeight:(int)subHeight
-                         width:(int)width
-                        height:(int)height {
-  int **blackPoints = (int **)malloc(subHeight * sizeof(int *));
-  for (int y = 0; y < subHeight; y++) {
-    blackPoints[y] = (int *)malloc(subWidth * sizeof(int));
+- (void)calculateBlackPoints:(int8_t *)luminances
+                      stride:(int)stride
+                  invertMask:(int)invertMask
+                    subWidth:(int)subWidth
+                   subHeight:(int)subHeight
+                       width:(int)width
+                      height:(int)height
+                 blackPoints:(int *)blackPoints
+             lowContrastMins:(int *)lowContrastMins {
 
-    int yoffset = y << ZX_BLOCK_SIZE_POWER;
-    int maxYOffset = height - ZX_BLOCK_SIZE;
-    if (yoffset > maxYOffset) {
-      yoffset = maxYOffset;
-    }
-    for (int x = 0; x < subWidth; x++) {
-      int xoffset = x << ZX_BLOCK_SIZE_POWER;
-      int maxXOffset = width - ZX_BLOCK_SIZE;
-      if (xoffset > maxXOffset) {
-        xoffset = maxXOffset;
+  // Gathering the block statistics touches every pixel, so it is split into bands. Low contrast
+  // blocks depend on the black points of their neighbors and are resolved afterwards.
+  ZXHybridBinarizerForEachBand(self.concurrency, subHeight, ^(int start, int end) {
+    for (int y = start; y < end; y++) {
+      int yoffset = y << ZX_BLOCK_SIZE_POWER;
+      int maxYOffset = height - ZX_BLOCK_SIZE;
+      if (yoffset > maxYOffset) {
+        yoffset = maxYOffset;
       }
-      int sum = 0;
-      int min = 0xFF;
-      int max = 0;
-      for (int yy = 0, offset = yoffset * width + xoffset; yy < ZX_BLOCK_SIZE; yy++, offset += width) {
-        for (int xx = 0; xx < ZX_BLOCK_SIZE; xx++) {
-          int pixel = luminances[offset + xx] & 0xFF;
-          sum += pixel;
-          // still looking for good contrast
-          if (pixel < min) {
-            min = pixel;
-          }
-          if (pixel > max) {
-            max = pixel;
-          }
-        }
-        // short-circuit min/max tests once dynamic range is met
-        if (max - min > ZX_MIN_DYNAMIC_RANGE) {
-          // finish the rest of the rows quickly
-          for (yy++, offset += width; yy < ZX_BLOCK_SIZE; yy++, offset += width) {
-            for (int xx = 0; xx < ZX_BLOCK_SIZE; xx++) {
-              sum += luminances[offset + xx] & 0xFF;
-            }
-          }
+      for (int x = 0; x < subWidth; x++) {
+        int xoffset = x << ZX_BLOCK_SIZE_POWER;
+        int maxXOffset = width - ZX_BLOCK_SIZE;
+        if (xoffset > maxXOffset) {
+          xoffset = maxXOffset;
         }
+        // The statistics kernels always scan the whole block rather than short-circuiting the min/max
+        // tests once the dynamic range is met. Only whether that range is exceeded matters below,
+        // and it cannot shrink as more pixels are seen, so the result is the same.
+        int sum;
+        int min;
+        int max;
+        ZXHybridBinarizerBlockStatistics(luminances + yoffset * stride + xoffset, stride, invertMask, &sum, &min, &max);
+
+        // The default estimate is the average of the values in the block.
+        blackPoints[y * subWidth + x] = sum >> (ZX_BLOCK_SIZE_POWER * 2);
+        // Low contrast blocks keep their minimum so they can be resolved below.
+        lowContrastMins[y * subWidth + x] = max - min <= ZX_MIN_DYNAMIC_RANGE ? min : -1;
       }
+    }
+  });
+
+  for (int y = 0; y < subHeight; y++) {
+    for (int x = 0; x < subWidth; x++) {
+      int min = lowContrastMins[y * subWidth + x];
+      if (min < 0) {
+        continue;
+      }
+      // If variation within the block is low, assume this is a block with only light or only
+      // dark pixels. In that case we do not want to use the average, as it would divide this
+      // low contrast area into black and white pixels, essentially creating data out of noise.
+      //
+      // The default assumption is that the block is light/background. Since no estimate for
+      // the level of dark pixels exists locally, use half the min for the block.
+      int average = min >> 1;
+
+      if (y > 0 && x > 0) {
+        // Correct the "white background" assumption for blocks that have neighbors by comparing
+        // the pixels in this block to the previously calculated black points. This is based on
+        // the fact that dark barcode symbology is always surrounded by some amount of light
+        // background for which reasonable black point estimates were made. The bp estimated at
+        // the boundaries is used for the interior.
 
-      // The default estimate is the average of the values in the block.
-      int average = sum >> (ZX_BLOCK_SIZE_POWER * 2);
-      if (max - min <= ZX_MIN_DYNAMIC_RANGE) {
-        // If variation within the block is low, assume this is a block with only light or only
-        // dark pixels. In that case we do not want to use the average, as it would divide this
-        // low contrast area into black and white pixels, essentially creating data out of noise.
-        //
-        // The default assumption is that the block is light/background. Since no estimate for
-        // the level of dark pixels exists locally, use half the min for the block.
-        average = min >> 1;
-
-        if (y > 0 && x > 0) {
-          // Correct the "white background" assumption for blocks that have neighbors by comparing
-          // the pixels in this block to the previously calculated black points. This is based on
-          // the fact that dark barcode symbology is always surrounded by some amount of light
-          // background for which reasonable black point estimates were made. The bp estimated at
-          // the boundaries is used for the interior.
-
-          // The (min < bp) is arbitrary but works better than other heuristics that were tried.
-          int averageNeighborBlackPoint = (blackPoints[y - 1][x] + (2 * blackPoints[y][x - 1]) +
-                                           blackPoints[y - 1][x - 1]) >> 2;
-          if (min < averageNeighborBlackPoint) {
-            average = averageNeighborBlackPoint;
-          }
+        // The (min < bp) is arbitrary but works better than other heuristics that were tried.
+        int averageNeighborBlackPoint = (blackPoints[(y - 1) * subWidth + x] + (2 * blackPoints[y * subWidth + x - 1]) +
+                                         blackPoints[(y - 1) * subWidth + x - 1]) >> 2;
+        if (min < averageNeighborBlackPoint) {
+          average = averageNeighborBlackPoint;
         }
       }
-      blackPoints[y][x] = average;
+      blackPoints[y * subWidth + x] = average;
     }
   }
-  return blackPoints;
 }
 
 @end
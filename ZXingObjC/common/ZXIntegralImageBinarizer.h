@@ -0,0 +1,45 @@
+/*
+ * Copyright 2014 ZXing authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "ZXBinarizer.h"
+
+@class ZXBitArray, ZXBitMatrix, ZXLuminanceSource;
+
+/**
+ * This Binarizer implementation compares each pixel against the mean luminance of a square window
+ * centered on it. The window sums come from a summed-area table, so each threshold costs the same
+ * regardless of the window size, unlike the fixed 5x5 grid of 8x8 blocks of ZXHybridBinarizer.
+ *
+ * blackRow:row:error: only sums the rows covered by the window around the requested row, so 1D
+ * readers sampling a few rows do not pay for a full-frame table. Each such row reads a window's
+ * worth of rows, so once the requested rows have read as many rows as the image has, the matrix
+ * is computed and the remaining rows are read from it instead.
+ */
+@interface ZXIntegralImageBinarizer : ZXBinarizer
+
+/**
+ * The side of the square window the mean is taken over, in pixels. Defaults to 0, which uses one
+ * eighth of the larger image dimension. Windows are at most 4095 pixels wide so that their sums
+ * fit in 32 bits.
+ */
+@property (nonatomic, assign) int windowSize;
+
+/**
+ * How far below the local mean, in percent, a pixel must be to be considered black. Defaults to 15.
+ */
+@property (nonatomic, assign) int bias;
+
+@end
@@ -0,0 +1,213 @@
+/*
+ * Copyright 2014 ZXing authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "ZXByteArray.h"
+#import "ZXIntegralImageBinarizer.h"
+
+const int ZX_INTEGRAL_DEFAULT_BIAS = 15;
+const int ZX_INTEGRAL_MINIMUM_WINDOW = 3;
+// 4095 * 4095 * 255 < 2^32, so the sum over one window fits in 32 bits
+const int ZX_INTEGRAL_MAXIMUM_WINDOW = 4095;
+
+@interface ZXIntegralImageBinarizer ()
+
+@property (nonatomic, strong) ZXBitMatrix *matrix;
+@property (nonatomic, assign) uint32_t *columnSums;
+@property (nonatomic, assign) int columnSumsCount;
+@property (nonatomic, assign) int summedRowCount;
+
+@end
+
+@implementation ZXIntegralImageBinarizer
+
+- (id)initWithSource:(ZXLuminanceSource *)source {
+  if (self = [super initWithSource:source]) {
+    _bias = ZX_INTEGRAL_DEFAULT_BIAS;
+  }
+
+  return self;
+}
+
+- (void)dealloc {
+  if (_columnSums != NULL) {
+    free(_columnSums);
+    _columnSums = NULL;
+  }
+}
+
+- (ZXBitArray *)blackRow:(int)y row:(ZXBitArray *)row error:(NSError **)error {
+  if (self.matrix != nil) {
+    return [self.matrix rowAtY:y row:row];
+  }
+
+  ZXLuminanceSource *source = self.luminanceSource;
+  int width = source.width;
+  int height = source.height;
+  int radius = [self windowRadius];
+  int top = MAX(0, y - radius);
+  int bottom = MIN(height, y + radius + 1);
+
+  // Each row reads every row of its window. Once the rows requested so far would have read as
+  // many rows as building the summed-area table does, build it and read rows from the matrix.
+  if (self.summedRowCount + (bottom - top) > height) {
+    ZXBitMatrix *matrix = [self blackMatrixWithError:error];
+    if (!matrix) {
+      return nil;
+    }
+    return [matrix rowAtY:y row:row];
+  }
+  self.summedRowCount += bottom - top;
+
+  if (row == nil || row.size < width) {
+    row = [[ZXBitArray alloc] initWithSize:width];
+  } else {
+    [row clear];
+  }
+
+  int stride;
+  BOOL inverted;
+  int8_t *luminances = [source luminancesWithRowStride:&stride inverted:&inverted];
+  ZXByteArray *luminanceMatrix NS_VALID_UNTIL_END_OF_SCOPE = nil;
+  if (luminances == NULL) {
+    luminanceMatrix = source.matrix;
+    luminances = luminanceMatrix.array;
+    stride = width;
+    inverted = NO;
+  }
+  int invertMask = inverted ? 0xFF : 0;
+
+  // Sum each column over the rows covered by the window, then prefix sum them along the row. As
+  // with the table below, the prefix sums may wrap but their differences are exact.
+  if (self.columnSumsCount < width + 1) {
+    free(self.columnSums);
+    self.columnSums = (uint32_t *)malloc((width + 1) * sizeof(uint32_t));
+    self.columnSumsCount = width + 1;
+  }
+  uint32_t *columnSums = self.columnSums;
+  memset(columnSums, 0, (width + 1) * sizeof(uint32_t));
+  for (int yy = top; yy < bottom; yy++) {
+    int8_t *pixels = luminances + yy * stride;
+    for (int x = 0; x < width; x++) {
+      columnSums[x + 1] += (pixels[x] & 0xFF) ^ invertMask;
+    }
+  }
+  for (int x = 0; x < width; x++) {
+    columnSums[x + 1] += columnSums[x];
+  }
+
+  int8_t *pixels = luminances + y * stride;
+  int32_t *bits = row.bits;
+  int64_t scale = 100 - self.bias;
+  for (int x = 0; x < width; x++) {
+    int left = MAX(0, x - radius);
+    int right = MIN(width, x + radius + 1);
+    int64_t count = (int64_t)(right - left) * (bottom - top);
+    int64_t sum = (uint32_t)(columnSums[right] - columnSums[left]);
+    int pixel = (pixels[x] & 0xFF) ^ invertMask;
+    if (pixel * count * 100 <= sum * scale) {
+      bits[x >> 5] |= 1 << (x & 0x1F);
+    }
+  }
+
+  return row;
+}
+
+- (ZXBitMatrix *)blackMatrixWithError:(NSError **)error {
+  if (self.matrix != nil) {
+    return self.matrix;
+  }
+
+  ZXLuminanceSource *source = self.luminanceSource;
+  int width = source.width;
+  int height = source.height;
+
+  int stride;
+  BOOL inverted;
+  int8_t *luminances = [source luminancesWithRowStride:&stride inverted:&inverted];
+  ZXByteArray *luminanceMatrix NS_VALID_UNTIL_END_OF_SCOPE = nil;
+  if (luminances == NULL) {
+    luminanceMatrix = source.matrix;
+    luminances = luminanceMatrix.array;
+    stride = width;
+    inverted = NO;
+  }
+  int invertMask = inverted ? 0xFF : 0;
+
+  // integral[y * (width + 1) + x] holds the sum of all pixels above and to the left of (x, y).
+  // The sums may wrap around on very large images, but the unsigned differences taken below are
+  // still exact since windowRadius keeps a single window sum within 32 bits.
+  int integralWidth = width + 1;
+  uint32_t *integral = (uint32_t *)calloc(integralWidth * (height + 1), sizeof(uint32_t));
+  for (int y = 0; y < height; y++) {
+    int8_t *pixels = luminances + y * stride;
+    uint32_t *previous = integral + y * integralWidth;
+    uint32_t *current = previous + integralWidth;
+    uint32_t rowSum = 0;
+    for (int x = 0; x < width; x++) {
+      rowSum += (pixels[x] & 0xFF) ^ invertMask;
+      current[x + 1] = previous[x + 1] + rowSum;
+    }
+  }
+
+  ZXBitMatrix *matrix = [[ZXBitMatrix alloc] initWithWidth:width height:height];
+  int32_t *bits = matrix.bits;
+  int rowSize = matrix.rowSize;
+  int radius = [self windowRadius];
+  int64_t scale = 100 - self.bias;
+  for (int y = 0; y < height; y++) {
+    int top = MAX(0, y - radius);
+    int bottom = MIN(height, y + radius + 1);
+    uint32_t *topRow = integral + top * integralWidth;
+    uint32_t *bottomRow = integral + bottom * integralWidth;
+    int8_t *pixels = luminances + y * stride;
+    int32_t *rowBits = bits + y * rowSize;
+    for (int x = 0; x < width; x++) {
+      int left = MAX(0, x - radius);
+      int right = MIN(width, x + radius + 1);
+      int64_t count = (int64_t)(right - left) * (bottom - top);
+      int64_t sum = (uint32_t)(bottomRow[right] - topRow[right] - bottomRow[left] + topRow[left]);
+      int pixel = (pixels[x] & 0xFF) ^ invertMask;
+      if (pixel * count * 100 <= sum * scale) {
+        rowBits[x >> 5] |= 1 << (x & 0x1F);
+      }
+    }
+  }
+  free(integral);
+
+  self.matrix = matrix;
+  return self.matrix;
+}
+
+- (ZXBinarizer *)createBinarizer:(ZXLuminanceSource *)source {
+  ZXIntegralImageBinarizer *binarizer = [[ZXIntegralImageBinarizer alloc] initWithSource:source];
+  binarizer.windowSize = self.windowSize;
+  binarizer.bias = self.bias;
+  return binarizer;
+}
+
+/**
+ * @return half the window size, computing the default window from the image dimensions if needed
+ *         and keeping it within ZX_INTEGRAL_MINIMUM_WINDOW and ZX_INTEGRAL_MAXIMUM_WINDOW
+ */
+- (int)windowRadius {
+  int windowSize = self.windowSize;
+  if (windowSize <= 0) {
+    windowSize = MAX(self.width, self.height) / 8;
+  }
+  return MIN(MAX(windowSize, ZX_INTEGRAL_MINIMUM_WINDOW), ZX_INTEGRAL_MAXIMUM_WINDOW) / 2;
+}
+
+@end
@@ -227,10 +227,12 @@ const int ZX_CORR = 1;
   float xStep = (bX - aX) / dist;
   float yStep = (bY - aY) / dist;
 
+  int32_t *bits = self.image.bits;
+  int rowSize = self.image.rowSize;
   for (int i = 0; i < dist; i++) {
     int x = [ZXMathUtils round:aX + i * xStep];
     int y = [ZXMathUtils round:aY + i * yStep];
-    if ([self.image getX:x y:y]) {
+    if (ZXBitMatrixGetBit(bits, rowSize, x, y)) {
       return [[ZXResultPoint alloc] initWithX:x y:y];
     }
   }
@@ -291,21 +293,16 @@ const int ZX_CORR = 1;
  * @return true if a black point has been found, else false.
  */
 - (BOOL)containsBlackPoint:(int)a b:(int)b fixed:(int)fixed horizontal:(BOOL)horizontal {
+  if (a > b) {
+    return NO;
+  }
+
+  int length = b - a + 1;
   if (horizontal) {
-    for (int x = a; x <= b; x++) {
-      if ([self.image getX:x y:fixed]) {
-        return YES;
-      }
-    }
+    return [self.image runLengthFromX:a y:fixed dx:1 dy:0 value:NO maxCount:length] < length;
   } else {
-    for (int y = a; y <= b; y++) {
-      if ([self.image getX:fixed y:y]) {
-        return YES;
-      }
-    }
+    return [self.image runLengthFromX:fixed y:a dx:0 dy:1 value:NO maxCount:length] < length;
   }
-
-  return NO;
 }
 
 @end
@@ -19,9 +19,17 @@
 /**
  * This class is the core bitmap class used by ZXing to represent 1 bit data. Reader objects
  * accept a BinaryBitmap and attempt to decode it.
+ *
+ * Rows and the matrix are cached as they are first asked for, without locking, so a bitmap must
+ * only be decoded by one thread at a time.
  */
 @interface ZXBinaryBitmap : NSObject
 
+/**
+ * @return The binarizer which converts the luminance data of this bitmap to 1 bit data.
+ */
+@property (nonatomic, strong, readonly) ZXBinarizer *binarizer;
+
 /**
  * @return The width of the bitmap.
  */
@@ -42,6 +50,23 @@
  */
 @property (nonatomic, readonly) BOOL rotateSupported;
 
+/**
+ * @return The number of distinct rows converted by blackRow:row:error:. Each row is binarized
+ *         at most once; later requests for it are served from a cache.
+ */
+@property (nonatomic, readonly) int binarizedRowCount;
+
+/**
+ * @return The number of blackRow:row:error: calls answered from the row cache.
+ */
+@property (nonatomic, readonly) int cachedRowCount;
+
+/**
+ * @return The number of pixels the binarizer has thresholded for this bitmap so far, counting
+ *         the rows converted for 1D readers and the whole matrix once it has been requested.
+ */
+@property (nonatomic, readonly) int binarizedPixelCount;
+
 - (id)initWithBinarizer:(ZXBinarizer *)binarizer;
 
 + (id)binaryBitmapWithBinarizer:(ZXBinarizer *)binarizer;
@@ -50,6 +75,7 @@
  * Converts one row of luminance data to 1 bit data. May actually do the conversion, or return
  * cached data. Callers should assume this method is expensive and call it as seldom as possible.
  * This method is intended for decoding 1D barcodes and may choose to apply sharpening.
+ * Converted rows are remembered, so readers asking for the same row again only pay for a copy.
  *
  * @param y The row to fetch, 0 <= y < bitmap height.
  * @param row An optional preallocated array. If null or too small, it will be ignored.
@@ -18,15 +18,19 @@
 #import "ZXBinaryBitmap.h"
 #import "ZXBitArray.h"
 #import "ZXBitMatrix.h"
+#import "ZXErrors.h"
 
 @interface ZXBinaryBitmap ()
 
-@property (nonatomic, strong, readonly) ZXBinarizer *binarizer;
 @property (nonatomic, strong) ZXBitMatrix *matrix;
 
 @end
 
-@implementation ZXBinaryBitmap
+@implementation ZXBinaryBitmap {
+  // Indexed by row: the converted row, the error converting it, or nil if not asked for yet
+  __strong id *_blackRows;
+  int _blackRowsLength;
+}
 
 - (id)initWithBinarizer:(ZXBinarizer *)binarizer {
   if (self = [super init]) {
@@ -35,11 +39,23 @@
     }
 
     _binarizer = binarizer;
+    _blackRowsLength = MAX(0, binarizer.height);
+    _blackRows = (__strong id *)calloc(_blackRowsLength, sizeof(id));
   }
 
   return self;
 }
 
+- (void)dealloc {
+  if (_blackRows != NULL) {
+    for (int i = 0; i < _blackRowsLength; i++) {
+      _blackRows[i] = nil;
+    }
+    free(_blackRows);
+    _blackRows = NULL;
+  }
+}
+
 + (id)binaryBitmapWithBinarizer:(ZXBinarizer *)binarizer {
   return [[self alloc] initWithBinarizer:binarizer];
 }
@@ -53,7 +69,36 @@
 }
 
 - (ZXBitArray *)blackRow:(int)y row:(ZXBitArray *)row error:(NSError **)error {
-  return [self.binarizer blackRow:y row:row error:error];
+  // Each row is binarized once and remembered, along with the error if it could not be. Callers
+  // are free to modify the returned row, and 1D readers reverse it in place, so they always get a
+  // copy of the cached bits.
+  if (y < 0 || y >= _blackRowsLength) {
+    return [self.binarizer blackRow:y row:row error:error];
+  }
+  id cached = _blackRows[y];
+  if (cached == nil) {
+    NSError *rowError = nil;
+    ZXBitArray *blackRow = [self.binarizer blackRow:y row:nil error:&rowError];
+    cached = blackRow ? blackRow : (rowError ? rowError : ZXNotFoundErrorInstance());
+    _blackRows[y] = cached;
+    _binarizedRowCount++;
+  } else {
+    _cachedRowCount++;
+  }
+
+  if ([cached isKindOfClass:[NSError class]]) {
+    if (error) *error = cached;
+    return nil;
+  }
+
+  ZXBitArray *blackRow = cached;
+  if (row == nil || row.size < blackRow.size) {
+    row = [[ZXBitArray alloc] initWithSize:blackRow.size];
+  } else {
+    [row clear];
+  }
+  memcpy(row.bits, blackRow.bits, ((blackRow.size + 31) / 32) * sizeof(int32_t));
+  return row;
 }
 
 - (ZXBitMatrix *)blackMatrixWithError:(NSError **)error {
@@ -63,6 +108,14 @@
   return self.matrix;
 }
 
+- (int)binarizedPixelCount {
+  int count = self.binarizedRowCount * self.width;
+  if (self.matrix != nil) {
+    count += self.width * self.height;
+  }
+  return count;
+}
+
 - (BOOL)cropSupported {
   return [self.binarizer luminanceSource].cropSupported;
 }
@@ -0,0 +1,35 @@
+/*
+ * Copyright 2014 ZXing authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Lets one thread ask readers working on another to give up. Readers whose ZXDecodeHints carry a
+ * cancelled token stop at their next row or scan line and fail with ZXNotFoundError.
+ */
+@interface ZXCancellationToken : NSObject
+
+/**
+ * A token created with a parent is also cancelled when its parent is.
+ */
+@property (nonatomic, strong, readonly) ZXCancellationToken *parent;
+@property (atomic, assign, readonly, getter = isCancelled) BOOL cancelled;
+
++ (id)token;
++ (id)tokenWithParent:(ZXCancellationToken *)parent;
+- (id)initWithParent:(ZXCancellationToken *)parent;
+
+- (void)cancel;
+
+@end
@@ -0,0 +1,51 @@
+/*
+ * Copyright 2014 ZXing authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "ZXCancellationToken.h"
+
+@implementation ZXCancellationToken {
+  volatile BOOL _cancelled;
+}
+
++ (id)token {
+  return [[self alloc] initWithParent:nil];
+}
+
++ (id)tokenWithParent:(ZXCancellationToken *)parent {
+  return [[self alloc] initWithParent:parent];
+}
+
+- (id)init {
+  return [self initWithParent:nil];
+}
+
+- (id)initWithParent:(ZXCancellationToken *)parent {
+  if (self = [super init]) {
+    _parent = parent;
+  }
+
+  return self;
+}
+
+- (BOOL)isCancelled {
+  return _cancelled || [self.parent isCancelled];
+}
+
+- (void)cancel {
+  _cancelled = YES;
+}
+
+@end
@@ -17,12 +17,14 @@
 #import "ZXBarcodeFormat.h"
 
 @protocol ZXResultPointCallback;
-@class ZXIntArray;
+@class ZXCancellationToken, ZXIntArray;
 
 /**
  * Encapsulates hints that a caller may pass to a barcode reader to help it
  * more quickly or accurately decode it. It is up to implementations to decide what,
  * if anything, to do with the information that is supplied.
+ *
+ * New hints must also be copied in copyWithZone:, since some readers decode with a copy.
  */
 @interface ZXDecodeHints : NSObject <NSCopying>
 
@@ -77,6 +79,37 @@
  */
 @property (nonatomic, assign) BOOL tryHarder;
 
+/**
+ * Number of horizontal bands a ZXHybridBinarizer may binarize concurrently. Useful for very large
+ * images such as document scans. Values of 0 or 1 binarize on the calling thread.
+ */
+@property (nonatomic, assign) int binarizerConcurrency;
+
+/**
+ * Rows with fewer black/white transitions than this are not passed to 1D readers at all. The
+ * smallest 1D symbols cross about 24 transitions. 0, the default, disables the check.
+ */
+@property (nonatomic, assign) int minimumRowTransitions;
+
+/**
+ * When minimumRowTransitions is set, those transitions must also bound a stretch of bars and
+ * spaces whose widest is at most this many times its narrowest, as in a barcode. Rows of text,
+ * speckle or texture are rejected. 0, the default, does not look at widths.
+ */
+@property (nonatomic, assign) float maximumRowRunRatio;
+
+/**
+ * Images are successive frames of a continuous scan. Readers that are kept across frames, as
+ * with ZXMultiFormatReader's decodeWithState:, start where they last found a barcode.
+ */
+@property (nonatomic, assign) BOOL continuousScan;
+
+/**
+ * Readers check this token between rows and scan lines and stop once it is cancelled. Copies of
+ * the hints share the token, so cancelling it reaches every reader of a decode.
+ */
+@property (nonatomic, strong) ZXCancellationToken *cancellationToken;
+
 /**
  * Allowed extension lengths for EAN or UPC barcodes. Other formats will ignore this.
  * Maps to an ZXIntArray of the allowed extension lengths, for example [2], [5], or [2, 5].
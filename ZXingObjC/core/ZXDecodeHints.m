@@ -37,10 +37,14 @@
   return [[self alloc] init];
 }
 
+// Every property must be copied here: readers run with copies of the hints, for example in
+// ZXMultiFormatReader's parallel mode and in ZXSharedMultiFormatReader, so a hint missing here
+// is silently ignored there.
 - (id)copyWithZone:(NSZone *)zone {
   ZXDecodeHints *result = [[[self class] allocWithZone:zone] init];
   if (result) {
     result.assumeCode39CheckDigit = self.assumeCode39CheckDigit;
+    result.assumeGS1 = self.assumeGS1;
     result.allowedLengths = [self.allowedLengths copy];
 
     for (NSNumber *formatNumber in self.barcodeFormats) {
@@ -53,6 +57,12 @@
     result.returnCodaBarStartEnd = self.returnCodaBarStartEnd;
     result.resultPointCallback = self.resultPointCallback;
     result.tryHarder = self.tryHarder;
+    result.binarizerConcurrency = self.binarizerConcurrency;
+    result.minimumRowTransitions = self.minimumRowTransitions;
+    result.maximumRowRunRatio = self.maximumRowRunRatio;
+    result.continuousScan = self.continuousScan;
+    result.cancellationToken = self.cancellationToken;
+    result.allowedEANExtensions = [self.allowedEANExtensions copy];
   }
 
   return result;
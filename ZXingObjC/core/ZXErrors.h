@@ -55,7 +55,8 @@ enum {
   ZXWriterError       = 1005
 };
 
-// Helper methods for error instances
+// Helper methods for error instances. Each returns a shared, immutable instance, so reporting a
+// failure does not allocate; compare errors by their code rather than by identity.
 NSError *ZXChecksumErrorInstance(void);
 NSError *ZXFormatErrorInstance(void);
 NSError *ZXNotFoundErrorInstance(void);
@@ -16,20 +16,35 @@
 
 #import "ZXErrors.h"
 
-NSError *ZXChecksumErrorInstance() {
-  NSDictionary *userInfo = @{NSLocalizedDescriptionKey: @"This barcode failed its checksum"};
+// NSError is immutable, so each kind of error is created once and shared: failing rows and
+// candidates report an error without allocating.
+static NSError *ZXErrorInstance(NSInteger code, NSString *description) {
+  return [[NSError alloc] initWithDomain:ZXErrorDomain code:code userInfo:@{NSLocalizedDescriptionKey: description}];
+}
 
-  return [[NSError alloc] initWithDomain:ZXErrorDomain code:ZXChecksumError userInfo:userInfo];
+NSError *ZXChecksumErrorInstance() {
+  static NSError *instance = nil;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    instance = ZXErrorInstance(ZXChecksumError, @"This barcode failed its checksum");
+  });
+  return instance;
 }
 
 NSError *ZXFormatErrorInstance() {
-  NSDictionary *userInfo = @{NSLocalizedDescriptionKey: @"This barcode does not confirm to the format's rules"};
-
-  return [[NSError alloc] initWithDomain:ZXErrorDomain code:ZXFormatError userInfo:userInfo];
+  static NSError *instance = nil;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    instance = ZXErrorInstance(ZXFormatError, @"This barcode does not confirm to the format's rules");
+  });
+  return instance;
 }
 
 NSError *ZXNotFoundErrorInstance() {
-  NSDictionary *userInfo = @{NSLocalizedDescriptionKey: @"A barcode was not found in this image"};
-
-  return [[NSError alloc] initWithDomain:ZXErrorDomain code:ZXNotFoundError userInfo:userInfo];
+  static NSError *instance = nil;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    instance = ZXErrorInstance(ZXNotFoundError, @"A barcode was not found in this image");
+  });
+  return instance;
 }
@@ -53,6 +53,13 @@
   return invertedMatrix;
 }
 
+- (int8_t *)luminancesWithRowStride:(int *)rowStride inverted:(BOOL *)inverted {
+  BOOL delegateInverted = NO;
+  int8_t *luminances = [self.delegate luminancesWithRowStride:rowStride inverted:&delegateInverted];
+  if (inverted) *inverted = !delegateInverted;
+  return luminances;
+}
+
 - (BOOL)cropSupported {
   return self.delegate.cropSupported;
 }
@@ -71,6 +71,21 @@
  */
 - (ZXByteArray *)matrix;
 
+/**
+ * Exposes the luminance data in place for sources which already hold it in memory, so callers
+ * can walk rows without the copies made by rowAtY:row: and matrix. The luminance of (x, y) is
+ * read as:
+ * int luminance = (base[y * rowStride + x] & 0xff) ^ (inverted ? 0xff : 0);
+ *
+ * The pointer is only valid while this source is alive. Do not modify the contents.
+ *
+ * @param rowStride Set to the number of bytes between the starts of consecutive rows
+ * @param inverted Set to YES if values must be inverted (255 - value) before use
+ * @return The address of the top-left luminance value, or NULL if this source cannot provide
+ *         direct access, in which case callers should fall back to matrix or rowAtY:row:
+ */
+- (int8_t *)luminancesWithRowStride:(int *)rowStride inverted:(BOOL *)inverted;
+
 /**
  * Returns a new object with cropped image data. Implementations may keep a reference to the
  * original data rather than a copy. Only callable if isCropSupported() is true.
@@ -43,6 +43,10 @@
                                userInfo:nil];
 }
 
+- (int8_t *)luminancesWithRowStride:(int *)rowStride inverted:(BOOL *)inverted {
+  return NULL;
+}
+
 - (ZXLuminanceSource *)crop:(int)left top:(int)top width:(int)width height:(int)height {
   @throw [NSException exceptionWithName:NSInternalInconsistencyException
                                  reason:@"This luminance source does not support cropping."
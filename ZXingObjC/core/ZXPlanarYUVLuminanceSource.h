@@ -16,6 +16,8 @@
 
 #import "ZXLuminanceSource.h"
 
+@class ZXByteArray;
+
 /**
  * This object extends LuminanceSource around an array of YUV data returned from the camera driver,
  * with the option to crop to a rectangle within the full data. This can be used to exclude
@@ -39,6 +41,33 @@
 - (id)initWithYuvData:(int8_t *)yuvData yuvDataLen:(int)yuvDataLen dataWidth:(int)dataWidth
            dataHeight:(int)dataHeight left:(int)left top:(int)top width:(int)width height:(int)height
     reverseHorizontal:(BOOL)reverseHorizontal;
+
+/**
+ * Wraps the Y plane of a camera frame without copying it. Only the luminance plane is referenced,
+ * so callers can pass the base address of a biplanar buffer directly. The source, its crops and
+ * any matrix views returned for contiguous rows all share the same memory.
+ *
+ * @param yPlane Base address of the luminance plane
+ * @param dataWidth Width of the full frame in pixels
+ * @param dataHeight Height of the full frame in pixels
+ * @param rowStride Number of bytes between the start of consecutive rows, at least dataWidth
+ * @param left Left edge of the crop rectangle
+ * @param top Top edge of the crop rectangle
+ * @param width Width of the crop rectangle
+ * @param height Height of the crop rectangle
+ * @param deallocator Invoked once when neither this source nor any of its crops need the plane
+ *                    any more; may be nil if the caller guarantees the plane outlives them
+ */
+- (id)initWithYPlaneNoCopy:(int8_t *)yPlane dataWidth:(int)dataWidth dataHeight:(int)dataHeight
+                 rowStride:(int)rowStride left:(int)left top:(int)top width:(int)width height:(int)height
+               deallocator:(void (^)(int8_t *yPlane))deallocator;
+
+/**
+ * Wraps a luminance plane which is already held in a ZXByteArray. The array is retained, not copied.
+ */
+- (id)initWithYPlane:(ZXByteArray *)yPlane dataWidth:(int)dataWidth dataHeight:(int)dataHeight
+           rowStride:(int)rowStride left:(int)left top:(int)top width:(int)width height:(int)height;
+
 - (int32_t *)renderThumbnail;
 
 @end
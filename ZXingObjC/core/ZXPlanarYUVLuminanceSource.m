@@ -24,6 +24,7 @@ const int THUMBNAIL_SCALE_FACTOR = 2;
 @property (nonatomic, strong, readonly) ZXByteArray *yuvData;
 @property (nonatomic, assign, readonly) int dataWidth;
 @property (nonatomic, assign, readonly) int dataHeight;
+@property (nonatomic, assign, readonly) int rowStride;
 @property (nonatomic, assign, readonly) int left;
 @property (nonatomic, assign, readonly) int top;
 
@@ -34,21 +35,49 @@ const int THUMBNAIL_SCALE_FACTOR = 2;
 - (id)initWithYuvData:(int8_t *)yuvData yuvDataLen:(int)yuvDataLen dataWidth:(int)dataWidth
            dataHeight:(int)dataHeight left:(int)left top:(int)top width:(int)width height:(int)height
     reverseHorizontal:(BOOL)reverseHorizontal {
+  // Only the Y plane is ever read, so leave the chroma planes behind.
+  int yLen = dataWidth * dataHeight;
+  ZXByteArray *yPlane = [[ZXByteArray alloc] initWithLength:yLen];
+  memcpy(yPlane.array, yuvData, MIN(yuvDataLen, yLen) * sizeof(int8_t));
+
+  if (self = [self initWithYPlane:yPlane dataWidth:dataWidth dataHeight:dataHeight rowStride:dataWidth
+                             left:left top:top width:width height:height]) {
+    if (reverseHorizontal) {
+      [self reverseHorizontal:width height:height];
+    }
+  }
+
+  return self;
+}
+
+- (id)initWithYPlaneNoCopy:(int8_t *)yPlane dataWidth:(int)dataWidth dataHeight:(int)dataHeight
+                 rowStride:(int)rowStride left:(int)left top:(int)top width:(int)width height:(int)height
+               deallocator:(void (^)(int8_t *yPlane))deallocator {
+  int yLen = rowStride * (dataHeight - 1) + dataWidth;
+  ZXByteArray *plane = [[ZXByteArray alloc] initWithBytesNoCopy:yPlane length:yLen deallocator:deallocator ? ^(int8_t *bytes, unsigned int length) {
+    deallocator(bytes);
+  } : nil];
+
+  return [self initWithYPlane:plane dataWidth:dataWidth dataHeight:dataHeight rowStride:rowStride
+                         left:left top:top width:width height:height];
+}
+
+- (id)initWithYPlane:(ZXByteArray *)yPlane dataWidth:(int)dataWidth dataHeight:(int)dataHeight
+           rowStride:(int)rowStride left:(int)left top:(int)top width:(int)width height:(int)height {
   if (self = [super initWithWidth:width height:height]) {
     if (left + width > dataWidth || top + height > dataHeight) {
       [NSException raise:NSInvalidArgumentException format:@"Crop rectangle does not fit within image data."];
     }
+    if (rowStride < dataWidth) {
+      [NSException raise:NSInvalidArgumentException format:@"Row stride must be at least the data width."];
+    }
 
-    _yuvData = [[ZXByteArray alloc] initWithLength:yuvDataLen];
-    memcpy(_yuvData.array, yuvData, yuvDataLen * sizeof(int8_t));
+    _yuvData = yPlane;
     _dataWidth = dataWidth;
     _dataHeight = dataHeight;
+    _rowStride = rowStride;
     _left = left;
     _top = top;
-
-    if (reverseHorizontal) {
-      [self reverseHorizontal:width height:height];
-    }
   }
 
   return self;
@@ -63,56 +92,65 @@ const int THUMBNAIL_SCALE_FACTOR = 2;
   if (!row || row.length < width) {
     row = [[ZXByteArray alloc] initWithLength:width];
   }
-  int offset = (y + self.top) * self.dataWidth + self.left;
-  memcpy(row.array, self.yuvData.array + offset, self.width * sizeof(int8_t));
+  int offset = (y + self.top) * self.rowStride + self.left;
+  memcpy(row.array, self.yuvData.array + offset, width * sizeof(int8_t));
   return row;
 }
 
 - (ZXByteArray *)matrix {
   int width = self.width;
   int height = self.height;
+  int rowStride = self.rowStride;
+  ZXByteArray *yuvData = self.yuvData;
 
   // If the caller asks for the entire underlying image, save the copy and give them the
   // original data. The docs specifically warn that result.length must be ignored.
-  if (width == self.dataWidth && height == self.dataHeight) {
-    return self.yuvData;
+  if (width == self.dataWidth && height == self.dataHeight && width == rowStride) {
+    return yuvData;
   }
 
-  int area = self.width * self.height;
-  ZXByteArray *matrix = [[ZXByteArray alloc] initWithLength:area];
-  int inputOffset = self.top * self.dataWidth + self.left;
+  int area = width * height;
+  int inputOffset = self.top * rowStride + self.left;
 
-  // If the width matches the full width of the underlying data, perform a single copy.
-  if (self.width == self.dataWidth) {
-    memcpy(matrix.array, self.yuvData.array + inputOffset, (area - inputOffset) * sizeof(int8_t));
-    return matrix;
+  // If the rows are contiguous in the underlying data, hand out a view onto it. The block keeps
+  // the plane alive for as long as the view is.
+  if (width == rowStride) {
+    return [[ZXByteArray alloc] initWithBytesNoCopy:yuvData.array + inputOffset length:area deallocator:^(int8_t *bytes, unsigned int length) {
+      (void)yuvData;
+    }];
   }
 
   // Otherwise copy one cropped row at a time.
-  ZXByteArray *yuvData = self.yuvData;
-  for (int y = 0; y < self.height; y++) {
-    int outputOffset = y * self.width;
-    memcpy(matrix.array + outputOffset, yuvData.array + inputOffset, self.width * sizeof(int8_t));
-    inputOffset += self.dataWidth;
+  ZXByteArray *matrix = [[ZXByteArray alloc] initWithLength:area];
+  for (int y = 0; y < height; y++) {
+    int outputOffset = y * width;
+    memcpy(matrix.array + outputOffset, yuvData.array + inputOffset, width * sizeof(int8_t));
+    inputOffset += rowStride;
   }
   return matrix;
 }
 
+- (int8_t *)luminancesWithRowStride:(int *)rowStride inverted:(BOOL *)inverted {
+  if (rowStride) *rowStride = self.rowStride;
+  if (inverted) *inverted = NO;
+  return self.yuvData.array + self.top * self.rowStride + self.left;
+}
+
 - (BOOL)cropSupported {
   return YES;
 }
 
 - (ZXLuminanceSource *)crop:(int)left top:(int)top width:(int)width height:(int)height {
-  return [[[self class] alloc] initWithYuvData:self.yuvData.array yuvDataLen:self.yuvData.length dataWidth:self.dataWidth
-                                    dataHeight:self.dataHeight left:self.left + left top:self.top + top
-                                         width:width height:height reverseHorizontal:NO];
+  return [[[self class] alloc] initWithYPlane:self.yuvData dataWidth:self.dataWidth dataHeight:self.dataHeight
+                                    rowStride:self.rowStride left:self.left + left top:self.top + top
+                                        width:width height:height];
 }
 
 - (int *)renderThumbnail {
   int thumbWidth = self.width / THUMBNAIL_SCALE_FACTOR;
   int thumbHeight = self.height / THUMBNAIL_SCALE_FACTOR;
   int *pixels = (int *)malloc(thumbWidth * thumbHeight * sizeof(int));
-  int inputOffset = self.top * self.dataWidth + self.left;
+  int inputOffset = self.top * self.rowStride + self.left;
 
   for (int y = 0; y < self.height; y++) {
     int outputOffset = y * self.width;
@@ -120,7 +158,7 @@ const int THUMBNAIL_SCALE_FACTOR = 2;
       int grey = self.yuvData.array[inputOffset + x * THUMBNAIL_SCALE_FACTOR] & 0xff;
       pixels[outputOffset + x] = 0xFF000000 | (grey * 0x00010101);
     }
-    inputOffset += self.dataWidth * THUMBNAIL_SCALE_FACTOR;
+    inputOffset += self.rowStride * THUMBNAIL_SCALE_FACTOR;
   }
   return pixels;
 }
@@ -134,7 +172,7 @@ const int THUMBNAIL_SCALE_FACTOR = 2;
 }
 
 - (void)reverseHorizontal:(int)width height:(int)height {
-  for (int y = 0, rowStart = self.top * self.dataWidth + self.left; y < height; y++, rowStart += self.dataWidth) {
+  for (int y = 0, rowStart = self.top * self.rowStride + self.left; y < height; y++, rowStart += self.rowStride) {
     int middle = rowStart + width / 2;
     for (int x1 = rowStart, x2 = rowStart + width - 1; x1 < middle; x1++, x2--) {
       int8_t temp = self.yuvData.array[x1];
@@ -119,6 +119,12 @@
   return matrix;
 }
 
+- (int8_t *)luminancesWithRowStride:(int *)rowStride inverted:(BOOL *)inverted {
+  if (rowStride) *rowStride = self.dataWidth;
+  if (inverted) *inverted = NO;
+  return self.luminances.array + self.top * self.dataWidth + self.left;
+}
+
 - (BOOL)cropSupported {
   return YES;
 }
@@ -24,6 +24,17 @@
  *
  * See ZXMultiFormatReader, which attempts to determine what barcode
  * format is present within the image as well, and then decodes it accordingly.
+ *
+ * ZXQRCodeReader, ZXDataMatrixReader, ZXAztecReader, ZXPDF417Reader and ZXMaxiCodeReader create
+ * whatever state a decode needs for each call and may be used from several threads at once. The
+ * 1D readers and ZXMultiFormatReader keep scratch buffers and state across rows and frames, so
+ * each instance must only be used by one thread at a time; ZXSharedMultiFormatReader hands each
+ * concurrent decode a reader of its own. The tables all readers decode with are static and built
+ * once, whatever the number of readers.
+ *
+ * In every case each thread must decode its own ZXBinaryBitmap. A bitmap caches its rows, its
+ * matrix and the matrix's transpose as they are first asked for, without locking, so two threads
+ * decoding the same bitmap race on those caches.
  */
 @protocol ZXReader <NSObject>
 
@@ -87,5 +87,26 @@ typedef enum {
    * If the code format supports structured append and the current scanned code is part of one then the
    * parity is given with it.
    */
-  kResultMetadataTypeStructuredAppendParity
+  kResultMetadataTypeStructuredAppendParity,
+
+  /**
+   * For 1D barcodes, the row of the scanned image the barcode was decoded from, counted from
+   * the top. When the barcode was found by rotating the image this is a row of the rotated
+   * image. Maps to an integer.
+   */
+  kResultMetadataTypeRowNumber,
+
+  /**
+   * For QR Code, Data Matrix and Aztec, the number of candidate points and records the detector
+   * tracked while finding the barcode. They are kept in plain C structs; each used to be an
+   * object. Maps to an integer.
+   */
+  kResultMetadataTypeDetectionCandidateCount,
+
+  /**
+   * For QR Code, Data Matrix and Aztec, the number of ZXResultPoint objects the detector created
+   * while finding the barcode, to compare with kResultMetadataTypeDetectionCandidateCount. Maps to
+   * an integer.
+   */
+  kResultMetadataTypeDetectionResultPointCount
 } ZXResultMetadataType;
@@ -25,6 +25,7 @@
 #import "ZXImage.h"
 
 // Common
+#import "ZXBinarizerContext.h"
 #import "ZXBitArray.h"
 #import "ZXBitMatrix.h"
 #import "ZXBitSource.h"
@@ -39,6 +40,7 @@
 #import "ZXGridSampler.h"
 #import "ZXHybridBinarizer.h"
 #import "ZXIntArray.h"
+#import "ZXIntegralImageBinarizer.h"
 #import "ZXMathUtils.h"
 #import "ZXMonochromeRectangleDetector.h"
 #import "ZXPerspectiveTransform.h"
@@ -52,6 +54,7 @@
 #import "ZXBinarizer.h"
 #import "ZXBinaryBitmap.h"
 #import "ZXByteMatrix.h"
+#import "ZXCancellationToken.h"
 #import "ZXDecodeHints.h"
 #import "ZXDimension.h"
 #import "ZXEncodeHints.h"
@@ -16,6 +16,7 @@
 
 #import "ZXBinaryBitmap.h"
 #import "ZXBitMatrix.h"
+#import "ZXCancellationToken.h"
 #import "ZXDataMatrixDecoder.h"
 #import "ZXDataMatrixDetector.h"
 #import "ZXDataMatrixReader.h"
@@ -54,6 +55,7 @@
 - (ZXResult *)decode:(ZXBinaryBitmap *)image hints:(ZXDecodeHints *)hints error:(NSError **)error {
   ZXDecoderResult *decoderResult;
   NSArray *points;
+  ZXDataMatrixDetector *detector = nil;
   if (hints != nil && hints.pureBarcode) {
     ZXBitMatrix *matrix = [image blackMatrixWithError:error];
     if (!matrix) {
@@ -74,7 +76,7 @@
     if (!matrix) {
       return nil;
     }
-    ZXDataMatrixDetector *detector = [[ZXDataMatrixDetector alloc] initWithImage:matrix error:error];
+    detector = [[ZXDataMatrixDetector alloc] initWithImage:matrix error:error];
     if (!detector) {
       return nil;
     }
@@ -82,6 +84,10 @@
     if (!detectorResult) {
       return nil;
     }
+    if (hints.cancellationToken.isCancelled) {
+      if (error) *error = ZXNotFoundErrorInstance();
+      return nil;
+    }
     decoderResult = [self.decoder decodeMatrix:detectorResult.bits error:error];
     if (!decoderResult) {
       return nil;
@@ -98,6 +104,10 @@
   if (decoderResult.ecLevel != nil) {
     [result putMetadata:kResultMetadataTypeErrorCorrectionLevel value:decoderResult.ecLevel];
   }
+  if (detector) {
+    [result putMetadata:kResultMetadataTypeDetectionCandidateCount value:@(detector.candidateUpdateCount)];
+    [result putMetadata:kResultMetadataTypeDetectionResultPointCount value:@(detector.resultPointAllocationCount)];
+  }
   return result;
 }
 
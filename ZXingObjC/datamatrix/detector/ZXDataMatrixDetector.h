@@ -22,6 +22,18 @@
  */
 @interface ZXDataMatrixDetector : NSObject
 
+/**
+ * @return The number of side transition counts and corner counts this detector tracked, in plain C
+ *         structs and arrays. Each used to be an object.
+ */
+@property (nonatomic, assign, readonly) int candidateUpdateCount;
+
+/**
+ * @return The number of ZXResultPoint objects this detector created while correcting the top
+ *         right corner.
+ */
+@property (nonatomic, assign, readonly) int resultPointAllocationCount;
+
 - (id)initWithImage:(ZXBitMatrix *)image error:(NSError **)error;
 
 /**
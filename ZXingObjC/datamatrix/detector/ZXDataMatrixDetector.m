@@ -23,38 +23,14 @@
 #import "ZXWhiteRectangleDetector.h"
 
 /**
- * Simply encapsulates two points and a number of transitions between them.
+ * Simply encapsulates two of the detected corners, as indexes into the corner points, and a
+ * number of transitions between them.
  */
-@interface ZXResultPointsAndTransitions : NSObject
-
-@property (nonatomic, strong, readonly) ZXResultPoint *from;
-@property (nonatomic, strong, readonly) ZXResultPoint *to;
-@property (nonatomic, assign, readonly) int transitions;
-
-@end
-
-@implementation ZXResultPointsAndTransitions
-
-- (id)initWithFrom:(ZXResultPoint *)from to:(ZXResultPoint *)to transitions:(int)transitions {
-  if (self = [super init]) {
-    _from = from;
-    _to = to;
-    _transitions = transitions;
-  }
-
-  return self;
-}
-
-- (NSString *)description {
-  return [NSString stringWithFormat:@"%@/%@/%d", self.from, self.to, self.transitions];
-}
-
-- (NSComparisonResult)compare:(ZXResultPointsAndTransitions *)otherObject {
-  return [@(self.transitions) compare:@(otherObject.transitions)];
-}
-
-@end
-
+typedef struct {
+  int from;
+  int to;
+  int transitions;
+} ZXDataMatrixSideTransitions;
 
 @interface ZXDataMatrixDetector ()
 
@@ -87,34 +63,58 @@
   ZXResultPoint *pointC = cornerPoints[2];
   ZXResultPoint *pointD = cornerPoints[3];
 
-  NSMutableArray *transitions = [NSMutableArray arrayWithCapacity:4];
-  [transitions addObject:[self transitionsBetween:pointA to:pointB]];
-  [transitions addObject:[self transitionsBetween:pointA to:pointC]];
-  [transitions addObject:[self transitionsBetween:pointB to:pointD]];
-  [transitions addObject:[self transitionsBetween:pointC to:pointD]];
-  [transitions sortUsingSelector:@selector(compare:)];
+  ZXResultPoint *points[4] = {pointA, pointB, pointC, pointD};
+
+  ZXDataMatrixSideTransitions transitions[4] = {
+    {0, 1, [self transitionsBetween:pointA to:pointB]},
+    {0, 2, [self transitionsBetween:pointA to:pointC]},
+    {1, 3, [self transitionsBetween:pointB to:pointD]},
+    {2, 3, [self transitionsBetween:pointC to:pointD]}
+  };
+  // Stable sort by number of transitions
+  for (int i = 1; i < 4; i++) {
+    ZXDataMatrixSideTransitions side = transitions[i];
+    int j = i - 1;
+    while (j >= 0 && transitions[j].transitions > side.transitions) {
+      transitions[j + 1] = transitions[j];
+      j--;
+    }
+    transitions[j + 1] = side;
+  }
 
-  ZXResultPointsAndTransitions *lSideOne = (ZXResultPointsAndTransitions *)transitions[0];
-  ZXResultPointsAndTransitions *lSideTwo = (ZXResultPointsAndTransitions *)transitions[1];
+  ZXDataMatrixSideTransitions lSideOne = transitions[0];
+  ZXDataMatrixSideTransitions lSideTwo = transitions[1];
 
-  NSMutableDictionary *pointCount = [NSMutableDictionary dictionary];
-  [self increment:pointCount key:[lSideOne from]];
-  [self increment:pointCount key:[lSideOne to]];
-  [self increment:pointCount key:[lSideTwo from]];
-  [self increment:pointCount key:[lSideTwo to]];
+  // Corners at the same position are counted together
+  int pointIndex[4];
+  for (int i = 0; i < 4; i++) {
+    pointIndex[i] = i;
+    for (int j = 0; j < i; j++) {
+      if ([points[j] isEqual:points[i]]) {
+        pointIndex[i] = pointIndex[j];
+        break;
+      }
+    }
+  }
+
+  int pointCount[4] = {0, 0, 0, 0};
+  pointCount[pointIndex[lSideOne.from]]++;
+  pointCount[pointIndex[lSideOne.to]]++;
+  pointCount[pointIndex[lSideTwo.from]]++;
+  pointCount[pointIndex[lSideTwo.to]]++;
+  _candidateUpdateCount += 8;
 
   ZXResultPoint *maybeTopLeft = nil;
   ZXResultPoint *bottomLeft = nil;
   ZXResultPoint *maybeBottomRight = nil;
-  for (ZXResultPoint *point in [pointCount allKeys]) {
-    NSNumber *value = pointCount[point];
-    if ([value intValue] == 2) {
-      bottomLeft = point;
-    } else {
+  for (int i = 0; i < 4; i++) {
+    if (pointCount[i] == 2) {
+      bottomLeft = points[i];
+    } else if (pointCount[i] > 0) {
       if (maybeTopLeft == nil) {
-        maybeTopLeft = point;
+        maybeTopLeft = points[i];
       } else {
-        maybeBottomRight = point;
+        maybeBottomRight = points[i];
       }
     }
   }
@@ -132,18 +132,18 @@
   ZXResultPoint *topLeft = corners[2];
 
   ZXResultPoint *topRight;
-  if (!pointCount[pointA]) {
+  if (pointCount[pointIndex[0]] == 0) {
     topRight = pointA;
-  } else if (!pointCount[pointB]) {
+  } else if (pointCount[pointIndex[1]] == 0) {
     topRight = pointB;
-  } else if (!pointCount[pointC]) {
+  } else if (pointCount[pointIndex[2]] == 0) {
     topRight = pointC;
   } else {
     topRight = pointD;
   }
 
-  int dimensionTop = [[self transitionsBetween:topLeft to:topRight] transitions];
-  int dimensionRight = [[self transitionsBetween:bottomRight to:topRight] transitions];
+  int dimensionTop = [self transitionsBetween:topLeft to:topRight];
+  int dimensionRight = [self transitionsBetween:bottomRight to:topRight];
 
   if ((dimensionTop & 0x01) == 1) {
     dimensionTop++;
@@ -164,8 +164,8 @@
       correctedTopRight = topRight;
     }
 
-    dimensionTop = [[self transitionsBetween:topLeft to:correctedTopRight] transitions];
-    dimensionRight = [[self transitionsBetween:bottomRight to:correctedTopRight] transitions];
+    dimensionTop = [self transitionsBetween:topLeft to:correctedTopRight];
+    dimensionRight = [self transitionsBetween:bottomRight to:correctedTopRight];
 
     if ((dimensionTop & 0x01) == 1) {
       dimensionTop++;
@@ -186,7 +186,7 @@
       correctedTopRight = topRight;
     }
 
-    int dimensionCorrected = MAX([[self transitionsBetween:topLeft to:correctedTopRight] transitions], [[self transitionsBetween:bottomRight to:correctedTopRight] transitions]);
+    int dimensionCorrected = MAX([self transitionsBetween:topLeft to:correctedTopRight], [self transitionsBetween:bottomRight to:correctedTopRight]);
     dimensionCorrected++;
     if ((dimensionCorrected & 0x01) == 1) {
       dimensionCorrected++;
@@ -220,6 +220,7 @@
   sin = ([topRight y] - [bottomRight y]) / norm;
 
   ZXResultPoint *c2 = [[ZXResultPoint alloc] initWithX:[topRight x] + corr * cos y:[topRight y] + corr * sin];
+  _resultPointAllocationCount += 2;
 
   if (![self isValid:c1]) {
     if ([self isValid:c2]) {
@@ -230,8 +231,8 @@
     return c1;
   }
 
-  int l1 = abs(dimensionTop - [[self transitionsBetween:topLeft to:c1] transitions]) + abs(dimensionRight - [[self transitionsBetween:bottomRight to:c1] transitions]);
-  int l2 = abs(dimensionTop - [[self transitionsBetween:topLeft to:c2] transitions]) + abs(dimensionRight - [[self transitionsBetween:bottomRight to:c2] transitions]);
+  int l1 = abs(dimensionTop - [self transitionsBetween:topLeft to:c1]) + abs(dimensionRight - [self transitionsBetween:bottomRight to:c1]);
+  int l2 = abs(dimensionTop - [self transitionsBetween:topLeft to:c2]) + abs(dimensionRight - [self transitionsBetween:bottomRight to:c2]);
 
   if (l1 <= l2) {
     return c1;
@@ -259,6 +260,7 @@
   sin = ([topRight y] - [bottomRight y]) / norm;
 
   ZXResultPoint *c2 = [[ZXResultPoint alloc] initWithX:[topRight x] + corr * cos y:[topRight y] + corr * sin];
+  _resultPointAllocationCount += 2;
 
   if (![self isValid:c1]) {
     if ([self isValid:c2]) {
@@ -269,8 +271,8 @@
     return c1;
   }
 
-  int l1 = abs([[self transitionsBetween:topLeft to:c1] transitions] - [[self transitionsBetween:bottomRight to:c1] transitions]);
-  int l2 = abs([[self transitionsBetween:topLeft to:c2] transitions] - [[self transitionsBetween:bottomRight to:c2] transitions]);
+  int l1 = abs([self transitionsBetween:topLeft to:c1] - [self transitionsBetween:bottomRight to:c1]);
+  int l2 = abs([self transitionsBetween:topLeft to:c2] - [self transitionsBetween:bottomRight to:c2]);
 
   return l1 <= l2 ? c1 : c2;
 }
@@ -283,14 +285,6 @@
   return [ZXMathUtils round:[ZXResultPoint distance:a pattern2:b]];
 }
 
-/**
- * Increments the Integer associated with a key by one.
- */
-- (void)increment:(NSMutableDictionary *)table key:(ZXResultPoint *)key {
-  NSNumber *value = table[key];
-  table[key] = value == nil ? @1 : @([value intValue] + 1);
-}
-
 - (ZXBitMatrix *)sampleGrid:(ZXBitMatrix *)image
                     topLeft:(ZXResultPoint *)topLeft
                  bottomLeft:(ZXResultPoint *)bottomLeft
@@ -316,44 +310,8 @@
 /**
  * Counts the number of black/white transitions between two points, using something like Bresenham's algorithm.
  */
-- (ZXResultPointsAndTransitions *)transitionsBetween:(ZXResultPoint *)from to:(ZXResultPoint *)to {
-  int fromX = (int)[from x];
-  int fromY = (int)[from y];
-  int toX = (int)[to x];
-  int toY = (int)[to y];
-  BOOL steep = abs(toY - fromY) > abs(toX - fromX);
-  if (steep) {
-    int temp = fromX;
-    fromX = fromY;
-    fromY = temp;
-    temp = toX;
-    toX = toY;
-    toY = temp;
-  }
-
-  int dx = abs(toX - fromX);
-  int dy = abs(toY - fromY);
-  int error = -dx >> 1;
-  int ystep = fromY < toY ? 1 : -1;
-  int xstep = fromX < toX ? 1 : -1;
-  int transitions = 0;
-  BOOL inBlack = [self.image getX:steep ? fromY : fromX y:steep ? fromX : fromY];
-  for (int x = fromX, y = fromY; x != toX; x += xstep) {
-    BOOL isBlack = [self.image getX:steep ? y : x y:steep ? x : y];
-    if (isBlack != inBlack) {
-      transitions++;
-      inBlack = isBlack;
-    }
-    error += dy;
-    if (error > 0) {
-      if (y == toY) {
-        break;
-      }
-      y += ystep;
-      error -= dx;
-    }
-  }
-  return [[ZXResultPointsAndTransitions alloc] initWithFrom:from to:to transitions:transitions];
+- (int)transitionsBetween:(ZXResultPoint *)from to:(ZXResultPoint *)to {
+  return [self.image transitionsFromX:(int)[from x] fromY:(int)[from y] toX:(int)[to x] toY:(int)[to y]];
 }
 
 @end
@@ -19,6 +19,7 @@
 #import "ZXDecodeHints.h"
 #import "ZXErrors.h"
 #import "ZXIntArray.h"
+#import "ZXOneDPatternFinder.h"
 #import "ZXResult.h"
 #import "ZXResultPoint.h"
 
@@ -55,11 +56,12 @@ const unichar ZX_CODA_STARTEND_ENCODING[]  = {'A', 'B', 'C', 'D'};
 // some industries use a checksum standard but this is not part of the original codabar standard
 // for more information see : http://www.mecsw.com/specs/codabar.html
 
-@interface ZXCodaBarReader ()
+@interface ZXCodaBarReader () <ZXOneDStartPatternMatcher>
 
 @property (nonatomic, strong) NSMutableString *decodeRowResult;
 @property (nonatomic, strong) ZXIntArray *counters;
 @property (nonatomic, assign) int counterLength;
+@property (nonatomic, assign) int firstBarRun;
 
 @end
 
@@ -88,7 +90,7 @@ const unichar ZX_CODA_STARTEND_ENCODING[]  = {'A', 'B', 'C', 'D'};
     return nil;
   }
 
-  int startOffset = [self findStartPattern];
+  int startOffset = [self findStartPattern:row];
   if (startOffset == -1) {
     if (error) *error = ZXNotFoundErrorInstance();
     return nil;
@@ -260,19 +262,12 @@ const unichar ZX_CODA_STARTEND_ENCODING[]  = {'A', 'B', 'C', 'D'};
   if (i >= end) {
     return NO;
   }
-  BOOL isWhite = YES;
-  int count = 0;
-  while (i < end) {
-    if ([row get:i] ^ isWhite) { // that is, exactly one is true
-      count++;
-    } else {
-      [self counterAppend:count];
-      count = 1;
-      isWhite = !isWhite;
-    }
-    i++;
+  // Every run from the first white one on is a counter
+  int runCount;
+  const int32_t *runStarts = [row runStartsWithCount:&runCount];
+  for (int run = [row runIndexAt:i]; run < runCount; run++) {
+    [self counterAppend:runStarts[run + 1] - runStarts[run]];
   }
-  [self counterAppend:count];
   return YES;
 }
 
@@ -286,25 +281,57 @@ const unichar ZX_CODA_STARTEND_ENCODING[]  = {'A', 'B', 'C', 'D'};
   }
 }
 
-- (int)findStartPattern {
-  for (int i = 1; i < self.counterLength; i += 2) {
-    int charOffset = [self toNarrowWidePattern:i];
-    if (charOffset != -1 && [[self class] arrayContains:ZX_CODA_STARTEND_ENCODING
-                                                 length:sizeof(ZX_CODA_STARTEND_ENCODING) / sizeof(unichar)
-                                                    key:ZX_CODA_ALPHABET[charOffset]]) {
-      // Look for whitespace before start pattern, >= 50% of width of start pattern
-      // We make an exception if the whitespace is the first element.
-      int patternSize = 0;
-      for (int j = i; j < i + 7; j++) {
-        patternSize += self.counters.array[j];
-      }
-      if (i == 1 || self.counters.array[i-1] >= patternSize / 2) {
-        return i;
-      }
+- (BOOL)mayDecodeReversedRow:(ZXBitArray *)row {
+  ZXIntArray *counters = [[ZXIntArray alloc] initWithLength:7];
+  return [ZXOneDReader matchPatternInReverse:row counters:counters matcher:^BOOL(int start, int end) {
+    // Reversed, white space must come before the start character and another character after it
+    if (start == 0 || end == row.size) {
+      return NO;
     }
-  }
+    int charOffset = [ZXCodaBarReader narrowWidePattern:counters.array];
+    if (charOffset == -1 || ![ZXCodaBarReader arrayContains:ZX_CODA_STARTEND_ENCODING
+                                                     length:sizeof(ZX_CODA_STARTEND_ENCODING) / sizeof(unichar)
+                                                        key:ZX_CODA_ALPHABET[charOffset]]) {
+      return NO;
+    }
+    // As in findStartPattern, the white space must be >= 50% of the width of the start character
+    // unless it is the first element
+    int whiteEnd = [row nextSet:end];
+    return whiteEnd - end >= (end - start) / 2 || [row nextUnset:whiteEnd] == row.size;
+  }];
+}
 
-  return -1;
+- (int)findStartPattern:(ZXBitArray *)row {
+  int run = [self startPatternRunInRow:row];
+  // Counters start with the first white run, just before the first bar
+  return run == -1 ? -1 : run - (self.firstBarRun - 1);
+}
+
+- (int)startPatternLength {
+  return 7;
+}
+
+- (BOOL)needsSortedWidths {
+  return NO;
+}
+
+- (int)firstStartPatternRunInFinder:(ZXOneDPatternFinder *)finder {
+  int firstWhite = [finder.row nextUnset:0];
+  self.firstBarRun = firstWhite < finder.row.size ? [finder firstBarRunFrom:firstWhite] : finder.runCount;
+  return self.firstBarRun;
+}
+
+- (BOOL)isStartPatternInFinder:(ZXOneDPatternFinder *)finder run:(int)run sortedWidths:(const int32_t *)sortedWidths {
+  int charOffset = [[self class] narrowWidePattern:finder.widths + run];
+  if (charOffset == -1 || ![[self class] arrayContains:ZX_CODA_STARTEND_ENCODING
+                                                length:sizeof(ZX_CODA_STARTEND_ENCODING) / sizeof(unichar)
+                                                   key:ZX_CODA_ALPHABET[charOffset]]) {
+    return NO;
+  }
+  // Look for whitespace before start pattern, >= 50% of width of start pattern
+  // We make an exception if the whitespace is the first element.
+  return run == self.firstBarRun ||
+    [finder whiteBeforeRun:run] >= (finder.runStarts[run + 7] - finder.runStarts[run]) / 2;
 }
 
 + (BOOL)arrayContains:(const unichar *)array length:(unsigned int)length key:(unichar)key {
@@ -320,15 +347,21 @@ const unichar ZX_CODA_STARTEND_ENCODING[]  = {'A', 'B', 'C', 'D'};
 
 // Assumes that counters[position] is a bar.
 - (int)toNarrowWidePattern:(int)position {
-  int32_t *array = self.counters.array;
   int end = position + 7;
   if (end >= self.counterLength) {
     return -1;
   }
+  return [[self class] narrowWidePattern:self.counters.array + position];
+}
 
+/**
+ * @param array the 7 counters of one character
+ * @return index of the character they encode or -1 if none
+ */
++ (int)narrowWidePattern:(const int32_t *)array {
   int maxBar = 0;
   int minBar = INT_MAX;
-  for (int j = position; j < end; j += 2) {
+  for (int j = 0; j < 7; j += 2) {
     int currentCounter = array[j];
     if (currentCounter < minBar) {
       minBar = currentCounter;
@@ -341,7 +374,7 @@ const unichar ZX_CODA_STARTEND_ENCODING[]  = {'A', 'B', 'C', 'D'};
 
   int maxSpace = 0;
   int minSpace = INT_MAX;
-  for (int j = position + 1; j < end; j += 2) {
+  for (int j = 1; j < 7; j += 2) {
     int currentCounter = array[j];
     if (currentCounter < minSpace) {
       minSpace = currentCounter;
@@ -357,7 +390,7 @@ const unichar ZX_CODA_STARTEND_ENCODING[]  = {'A', 'B', 'C', 'D'};
   for (int i = 0; i < 7; i++) {
     int threshold = (i & 1) == 0 ? thresholdBar : thresholdSpace;
     bitmask >>= 1;
-    if (array[position + i] > threshold) {
+    if (array[i] > threshold) {
       pattern |= bitmask;
     }
   }
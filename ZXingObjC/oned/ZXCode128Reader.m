@@ -138,6 +138,9 @@ const int ZX_CODE128_CODE_PATTERNS[ZX_CODE128_CODE_PATTERNS_LEN][7] = {
 static int ZX_CODE128_MAX_AVG_VARIANCE = -1;
 static int ZX_CODE128_MAX_INDIVIDUAL_VARIANCE = -1;
 
+// Code of each pattern by its first six element widths, two bits each less one, or -1
+static int8_t ZX_CODE128_CODE_LOOKUP[1 << 12];
+
 const int ZX_CODE128_CODE_SHIFT = 98;
 const int ZX_CODE128_CODE_CODE_C = 99;
 const int ZX_CODE128_CODE_CODE_B = 100;
@@ -152,6 +155,32 @@ const int ZX_CODE128_CODE_START_B = 104;
 const int ZX_CODE128_CODE_START_C = 105;
 const int ZX_CODE128_CODE_STOP = 106;
 
+// The start code counters match best, or -1 if none matches well enough
+static int ZXCode128StartCode(ZXIntArray *counters) {
+  int code;
+  int variance;
+  if ([ZXOneDReader lookupPattern:counters patternLength:11 lookup:ZX_CODE128_CODE_LOOKUP maxIndividualVariance:ZX_CODE128_MAX_INDIVIDUAL_VARIANCE pattern:&code variance:&variance]) {
+    if (variance >= ZX_CODE128_MAX_AVG_VARIANCE) {
+      // No start code is nearer than the nearest pattern
+      return -1;
+    }
+    if (code >= ZX_CODE128_CODE_START_A && code <= ZX_CODE128_CODE_START_C) {
+      return code;
+    }
+  }
+
+  int bestVariance = ZX_CODE128_MAX_AVG_VARIANCE;
+  int bestMatch = -1;
+  for (int startCode = ZX_CODE128_CODE_START_A; startCode <= ZX_CODE128_CODE_START_C; startCode++) {
+    int variance = [ZXOneDReader patternMatchVariance:counters pattern:ZX_CODE128_CODE_PATTERNS[startCode] maxIndividualVariance:ZX_CODE128_MAX_INDIVIDUAL_VARIANCE];
+    if (variance < bestVariance) {
+      bestVariance = variance;
+      bestMatch = startCode;
+    }
+  }
+  return bestMatch;
+}
+
 @implementation ZXCode128Reader
 
 + (void)initialize {
@@ -162,6 +191,26 @@ const int ZX_CODE128_CODE_STOP = 106;
   if (ZX_CODE128_MAX_INDIVIDUAL_VARIANCE == -1) {
     ZX_CODE128_MAX_INDIVIDUAL_VARIANCE = (int)(ZX_ONED_PATTERN_MATCH_RESULT_SCALE_FACTOR * 0.7f);
   }
+
+  if (self != [ZXCode128Reader class]) {
+    return;
+  }
+  memset(ZX_CODE128_CODE_LOOKUP, -1, sizeof(ZX_CODE128_CODE_LOOKUP));
+  for (int d = 0; d < ZX_CODE128_CODE_PATTERNS_LEN; d++) {
+    int key = 0;
+    for (int i = 0; i < 6; i++) {
+      key |= (ZX_CODE128_CODE_PATTERNS[d][i] - 1) << (i << 1);
+    }
+    ZX_CODE128_CODE_LOOKUP[key] = d;
+  }
+}
+
+- (BOOL)mayDecodeReversedRow:(ZXBitArray *)row {
+  // Reversed, the row must hold a start code with white space before it, >= 50% of its width
+  ZXIntArray *counters = [[ZXIntArray alloc] initWithLength:6];
+  return [ZXOneDReader matchPatternInReverse:row counters:counters matcher:^BOOL(int start, int end) {
+    return [row isRange:end end:MIN(row.size, end + (end - start) / 2) value:NO] && ZXCode128StartCode(counters) >= 0;
+  }];
 }
 
 - (ZXIntArray *)findStartPattern:(ZXBitArray *)row {
@@ -175,20 +224,18 @@ const int ZX_CODE128_CODE_STOP = 106;
   BOOL isWhite = NO;
   int patternLength = (int)counters.length;
 
-  for (int i = rowOffset; i < width; i++) {
+  int runCount;
+  const int32_t *runStarts = [row runStartsWithCount:&runCount];
+  int i = rowOffset;
+  int run = i < width ? [row runIndexAt:i] : runCount;
+  while (i < width) {
     if ([row get:i] ^ isWhite) {
-      array[counterPosition]++;
+      // Count the rest of this run at once
+      array[counterPosition] += runStarts[run + 1] - i;
+      i = runStarts[++run];
     } else {
       if (counterPosition == patternLength - 1) {
-        int bestVariance = ZX_CODE128_MAX_AVG_VARIANCE;
-        int bestMatch = -1;
-        for (int startCode = ZX_CODE128_CODE_START_A; startCode <= ZX_CODE128_CODE_START_C; startCode++) {
-          int variance = [ZXOneDReader patternMatchVariance:counters pattern:ZX_CODE128_CODE_PATTERNS[startCode] maxIndividualVariance:ZX_CODE128_MAX_INDIVIDUAL_VARIANCE];
-          if (variance < bestVariance) {
-            bestVariance = variance;
-            bestMatch = startCode;
-          }
-        }
+        int bestMatch = ZXCode128StartCode(counters);
         // Look for whitespace before start pattern, >= 50% of width of start pattern
         if (bestMatch >= 0 &&
             [row isRange:MAX(0, patternStart - (i - patternStart) / 2) end:patternStart value:NO]) {
@@ -204,7 +251,7 @@ const int ZX_CODE128_CODE_STOP = 106;
       } else {
         counterPosition++;
       }
-      array[counterPosition] = 1;
+      array[counterPosition] = 0;
       isWhite = !isWhite;
     }
   }
@@ -216,9 +263,14 @@ const int ZX_CODE128_CODE_STOP = 106;
   if (![ZXOneDReader recordPattern:row start:rowOffset counters:counters]) {
     return -1;
   }
-  int bestVariance = ZX_CODE128_MAX_AVG_VARIANCE;
-  int bestMatch = -1;
+  int bestMatch;
+  int bestVariance;
+  if ([ZXOneDReader lookupPattern:counters patternLength:11 lookup:ZX_CODE128_CODE_LOOKUP maxIndividualVariance:ZX_CODE128_MAX_INDIVIDUAL_VARIANCE pattern:&bestMatch variance:&bestVariance]) {
+    return bestVariance < ZX_CODE128_MAX_AVG_VARIANCE ? bestMatch : -1;
+  }
 
+  bestVariance = ZX_CODE128_MAX_AVG_VARIANCE;
+  bestMatch = -1;
   for (int d = 0; d < ZX_CODE128_CODE_PATTERNS_LEN; d++) {
     int variance = [ZXOneDReader patternMatchVariance:counters pattern:ZX_CODE128_CODE_PATTERNS[d] maxIndividualVariance:ZX_CODE128_MAX_INDIVIDUAL_VARIANCE];
     if (variance < bestVariance) {
@@ -18,6 +18,7 @@
 #import "ZXCode39Reader.h"
 #import "ZXErrors.h"
 #import "ZXIntArray.h"
+#import "ZXOneDPatternFinder.h"
 #import "ZXResult.h"
 #import "ZXResultPoint.h"
 
@@ -42,7 +43,7 @@ const int ZX_CODE39_CHARACTER_ENCODINGS[] = {
 
 const int ZX_CODE39_ASTERISK_ENCODING = 0x094;
 
-@interface ZXCode39Reader ()
+@interface ZXCode39Reader () <ZXOneDStartPatternMatcher>
 
 @property (nonatomic, assign, readonly) BOOL extendedMode;
 @property (nonatomic, assign, readonly) BOOL usingCheckDigit;
@@ -80,13 +81,17 @@ const int ZX_CODE39_ASTERISK_ENCODING = 0x094;
   [theCounters clear];
   NSMutableString *result = [NSMutableString stringWithCapacity:20];
 
-  ZXIntArray *start = [self findAsteriskPattern:row counters:theCounters];
-  if (!start) {
+  int startRun = [self startPatternRunInRow:row];
+  if (startRun == -1) {
     if (error) *error = ZXNotFoundErrorInstance();
     return nil;
   }
+  int runCount;
+  const int32_t *runStarts = [row runStartsWithCount:&runCount];
+  int patternStart = runStarts[startRun];
+  int patternEnd = runStarts[startRun + theCounters.length];
   // Read off white space
-  int nextStart = [row nextSet:start.array[1]];
+  int nextStart = [row nextSet:patternEnd];
   int end = [row size];
 
   unichar decodedChar;
@@ -156,7 +161,7 @@ const int ZX_CODE39_ASTERISK_ENCODING = 0x094;
     resultString = result;
   }
 
-  float left = (float) (start.array[1] + start.array[0]) / 2.0f;
+  float left = (float) (patternEnd + patternStart) / 2.0f;
   float right = (lastStart + lastPatternSize) / 2.0f;
 
   return [ZXResult resultWithText:resultString
@@ -166,41 +171,33 @@ const int ZX_CODE39_ASTERISK_ENCODING = 0x094;
                            format:kBarcodeFormatCode39];
 }
 
-- (ZXIntArray *)findAsteriskPattern:(ZXBitArray *)row counters:(ZXIntArray *)counters {
-  int width = row.size;
-  int rowOffset = [row nextSet:0];
+- (BOOL)mayDecodeReversedRow:(ZXBitArray *)row {
+  // Reversed, the row must start with an asterisk with white space before it, >= 50% of its width
+  ZXIntArray *counters = [[ZXIntArray alloc] initWithLength:self.counters.length];
+  return [ZXOneDReader matchPatternInReverse:row counters:counters matcher:^BOOL(int start, int end) {
+    return [self toNarrowWidePattern:counters] == ZX_CODE39_ASTERISK_ENCODING &&
+      [row isRange:end end:MIN(row.size, end + ((end - start) >> 1)) value:NO];
+  }];
+}
 
-  int counterPosition = 0;
-  int patternStart = rowOffset;
-  BOOL isWhite = NO;
-  int patternLength = counters.length;
-  int32_t *array = counters.array;
+- (int)startPatternLength {
+  return self.counters.length;
+}
 
-  for (int i = rowOffset; i < width; i++) {
-    if ([row get:i] ^ isWhite) {
-      array[counterPosition]++;
-    } else {
-      if (counterPosition == patternLength - 1) {
-        if ([self toNarrowWidePattern:counters] == ZX_CODE39_ASTERISK_ENCODING &&
-            [row isRange:MAX(0, patternStart - ((i - patternStart) >> 1)) end:patternStart value:NO]) {
-          return [[ZXIntArray alloc] initWithInts:patternLength, i, -1];
-        }
-        patternStart += array[0] + array[1];
-        for (int y = 2; y < counters.length; y++) {
-          array[y - 2] = array[y];
-        }
-        array[patternLength - 2] = 0;
-        array[patternLength - 1] = 0;
-        counterPosition--;
-      } else {
-        counterPosition++;
-      }
-      array[counterPosition] = 1;
-      isWhite = !isWhite;
-    }
-  }
+- (BOOL)needsSortedWidths {
+  return YES;
+}
 
-  return nil;
+- (int)firstStartPatternRunInFinder:(ZXOneDPatternFinder *)finder {
+  return [finder firstBarRunFrom:0];
+}
+
+- (BOOL)isStartPatternInFinder:(ZXOneDPatternFinder *)finder run:(int)run sortedWidths:(const int32_t *)sortedWidths {
+  int patternStart = finder.runStarts[run];
+  int patternEnd = finder.runStarts[run + self.counters.length];
+  // Look for whitespace before start pattern, >= 50% of width of start pattern
+  return [self toNarrowWidePattern:finder.widths + run sortedCounters:sortedWidths] == ZX_CODE39_ASTERISK_ENCODING &&
+    [finder whiteBeforeRun:run] >= MIN(patternStart, (patternEnd - patternStart) >> 1);
 }
 
 - (int)toNarrowWidePattern:(ZXIntArray *)counters {
@@ -244,6 +241,31 @@ const int ZX_CODE39_ASTERISK_ENCODING = 0x094;
   return -1;
 }
 
+/**
+ * Same as toNarrowWidePattern: for the nine counters in array, given them in ascending order too.
+ * The three wide counters have to be the three widest, and wider than all others, so no threshold
+ * search is needed.
+ */
+- (int)toNarrowWidePattern:(const int32_t *)array sortedCounters:(const int32_t *)sorted {
+  int numCounters = self.counters.length;
+  int maxNarrowCounter = sorted[numCounters - 4];
+  if (sorted[numCounters - 3] == maxNarrowCounter) {
+    return -1;
+  }
+  int totalWideCountersWidth = sorted[numCounters - 3] + sorted[numCounters - 2] + sorted[numCounters - 1];
+  int pattern = 0;
+  for (int i = 0; i < numCounters; i++) {
+    int counter = array[i];
+    if (counter > maxNarrowCounter) {
+      if ((counter << 1) >= totalWideCountersWidth) {
+        return -1;
+      }
+      pattern |= 1 << (numCounters - 1 - i);
+    }
+  }
+  return pattern;
+}
+
 - (unichar)patternToChar:(int)pattern {
   for (int i = 0; i < sizeof(ZX_CODE39_CHARACTER_ENCODINGS) / sizeof(int); i++) {
     if (ZX_CODE39_CHARACTER_ENCODINGS[i] == pattern) {
@@ -18,6 +18,7 @@
 #import "ZXCode93Reader.h"
 #import "ZXErrors.h"
 #import "ZXIntArray.h"
+#import "ZXOneDPatternFinder.h"
 #import "ZXResult.h"
 #import "ZXResultPoint.h"
 
@@ -41,7 +42,7 @@ const int ZX_CODE93_CHARACTER_ENCODINGS[] = {
 
 const int ZX_CODE93_ASTERISK_ENCODING = 0x15E;
 
-@interface ZXCode93Reader ()
+@interface ZXCode93Reader () <ZXOneDStartPatternMatcher>
 
 @property (nonatomic, strong, readonly) ZXIntArray *counters;
 
@@ -63,13 +64,17 @@ const int ZX_CODE93_ASTERISK_ENCODING = 0x15E;
 }
 
 - (ZXResult *)decodeRow:(int)rowNumber row:(ZXBitArray *)row hints:(ZXDecodeHints *)hints error:(NSError **)error {
-  ZXIntArray *start = [self findAsteriskPattern:row];
-  if (!start) {
+  int startRun = [self startPatternRunInRow:row];
+  if (startRun == -1) {
     if (error) *error = ZXNotFoundErrorInstance();
     return nil;
   }
+  int runCount;
+  const int32_t *runStarts = [row runStartsWithCount:&runCount];
+  int patternStart = runStarts[startRun];
+  int patternEnd = runStarts[startRun + self.counters.length];
   // Read off white space
-  int nextStart = [row nextSet:start.array[1]];
+  int nextStart = [row nextSet:patternEnd];
   int end = row.size;
 
   ZXIntArray *theCounters = self.counters;
@@ -128,7 +133,7 @@ const int ZX_CODE93_ASTERISK_ENCODING = 0x15E;
     return nil;
   }
 
-  float left = (float) (start.array[1] + start.array[0]) / 2.0f;
+  float left = (float) (patternEnd + patternStart) / 2.0f;
   float right = lastStart + lastPatternSize / 2.0f;
   return [ZXResult resultWithText:resultString
                          rawBytes:nil
@@ -137,47 +142,38 @@ const int ZX_CODE93_ASTERISK_ENCODING = 0x15E;
                            format:kBarcodeFormatCode93];
 }
 
-- (ZXIntArray *)findAsteriskPattern:(ZXBitArray *)row {
-  int width = row.size;
-  int rowOffset = [row nextSet:0];
+- (BOOL)mayDecodeReversedRow:(ZXBitArray *)row {
+  ZXIntArray *counters = [[ZXIntArray alloc] initWithLength:self.counters.length];
+  return [ZXOneDReader matchPatternInReverse:row counters:counters matcher:^BOOL(int start, int end) {
+    return [self toPattern:counters] == ZX_CODE93_ASTERISK_ENCODING;
+  }];
+}
 
-  [self.counters clear];
-  ZXIntArray *theCounters = self.counters;
-  int patternStart = rowOffset;
-  BOOL isWhite = NO;
-  int patternLength = theCounters.length;
-
-  int counterPosition = 0;
-  for (int i = rowOffset; i < width; i++) {
-    if ([row get:i] ^ isWhite) {
-      theCounters.array[counterPosition]++;
-    } else {
-      if (counterPosition == patternLength - 1) {
-        if ([self toPattern:theCounters] == ZX_CODE93_ASTERISK_ENCODING) {
-          return [[ZXIntArray alloc] initWithInts:patternStart, i, -1];
-        }
-        patternStart += theCounters.array[0] + theCounters.array[1];
-        for (int y = 2; y < patternLength; y++) {
-          theCounters.array[y - 2] = theCounters.array[y];
-        }
-        theCounters.array[patternLength - 2] = 0;
-        theCounters.array[patternLength - 1] = 0;
-        counterPosition--;
-      } else {
-        counterPosition++;
-      }
-      theCounters.array[counterPosition] = 1;
-      isWhite = !isWhite;
-    }
-  }
+- (int)startPatternLength {
+  return self.counters.length;
+}
 
-  return nil;
+- (BOOL)needsSortedWidths {
+  return NO;
+}
+
+- (int)firstStartPatternRunInFinder:(ZXOneDPatternFinder *)finder {
+  return [finder firstBarRunFrom:0];
+}
+
+- (BOOL)isStartPatternInFinder:(ZXOneDPatternFinder *)finder run:(int)run sortedWidths:(const int32_t *)sortedWidths {
+  return [self toPattern:finder.widths + run length:self.counters.length] == ZX_CODE93_ASTERISK_ENCODING;
 }
 
 - (int)toPattern:(ZXIntArray *)counters {
-  int max = counters.length;
-  int sum = [counters sum];
-  int32_t *array = counters.array;
+  return [self toPattern:counters.array length:counters.length];
+}
+
+- (int)toPattern:(const int32_t *)array length:(int)max {
+  int sum = 0;
+  for (int i = 0; i < max; i++) {
+    sum += array[i];
+  }
   int pattern = 0;
   for (int i = 0; i < max; i++) {
     int scaledShifted = (array[i] << ZX_ONED_INTEGER_MATH_SHIFT) * 9 / sum;
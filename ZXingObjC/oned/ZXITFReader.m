@@ -80,51 +80,37 @@ const int ZX_ITF_PATTERNS[ZX_ITF_PATTERNS_LEN][5] = {
 
 - (ZXResult *)decodeRow:(int)rowNumber row:(ZXBitArray *)row hints:(ZXDecodeHints *)hints error:(NSError **)error {
   // Find out where the Middle section (payload) starts & ends
+  // The start guard and its quiet zone are checked first, so rows without one are never reversed
   ZXIntArray *startRange = [self decodeStart:row];
-  ZXIntArray *endRange = [self decodeEnd:row];
-  if (!startRange || !endRange) {
+  if (!startRange) {
     if (error) *error = ZXNotFoundErrorInstance();
     return nil;
   }
-
-  NSMutableString *resultString = [NSMutableString stringWithCapacity:20];
-  if (![self decodeMiddle:row payloadStart:startRange.array[1] payloadEnd:endRange.array[0] resultString:resultString]) {
+  ZXIntArray *endRange = [self decodeEnd:row];
+  if (!endRange) {
     if (error) *error = ZXNotFoundErrorInstance();
     return nil;
   }
 
-  NSArray *allowedLengths = nil;
-  if (hints != nil) {
-    allowedLengths = hints.allowedLengths;
+  // Each pair of digits is exactly ten runs, so the length of the result is known before
+  // decoding: reject rows which could not give an allowed length without decoding them. Without
+  // the payload decoded such a row may hold no barcode at all, so it is not found rather than
+  // badly formatted.
+  int payloadStart = startRange.array[1];
+  int payloadEnd = endRange.array[0];
+  int length = 0;
+  if (payloadStart < payloadEnd) {
+    int payloadRuns = [row runIndexAt:payloadEnd] - [row runIndexAt:payloadStart];
+    length = (payloadRuns + 9) / 10 * 2;
   }
-  if (allowedLengths == nil) {
-    NSMutableArray *temp = [NSMutableArray array];
-    for (int i = 0; i < sizeof(ZX_ITF_DEFAULT_ALLOWED_LENGTHS) / sizeof(int); i++) {
-      [temp addObject:@(ZX_ITF_DEFAULT_ALLOWED_LENGTHS[i])];
-    }
-    allowedLengths = [NSArray arrayWithArray:temp];
+  if (![self isAllowedLength:length allowedLengths:hints.allowedLengths]) {
+    if (error) *error = ZXNotFoundErrorInstance();
+    return nil;
   }
 
-  // To avoid false positives with 2D barcodes (and other patterns), make
-  // an assumption that the decoded string must be a 'standard' length if it's short
-  NSUInteger length = [resultString length];
-  BOOL lengthOK = NO;
-  int maxAllowedLength = 0;
-  for (NSNumber *i in allowedLengths) {
-    int allowedLength = [i intValue];
-    if (length == allowedLength) {
-      lengthOK = YES;
-      break;
-    }
-    if (allowedLength > maxAllowedLength) {
-      maxAllowedLength = allowedLength;
-    }
-  }
-  if (!lengthOK && length > maxAllowedLength) {
-    lengthOK = YES;
-  }
-  if (!lengthOK) {
-    if (error) *error = ZXFormatErrorInstance();
+  NSMutableString *resultString = [NSMutableString stringWithCapacity:length];
+  if (![self decodeMiddle:row payloadStart:payloadStart payloadEnd:payloadEnd resultString:resultString]) {
+    if (error) *error = ZXNotFoundErrorInstance();
     return nil;
   }
 
@@ -135,6 +121,35 @@ const int ZX_ITF_PATTERNS[ZX_ITF_PATTERNS_LEN][5] = {
                            format:kBarcodeFormatITF];
 }
 
+/**
+ * To avoid false positives with 2D barcodes (and other patterns), make
+ * an assumption that the decoded string must be a 'standard' length if it's short.
+ *
+ * @param length         number of digits the row decodes to
+ * @param allowedLengths allowed lengths from the hints, or nil for ZX_ITF_DEFAULT_ALLOWED_LENGTHS
+ * @return YES if length is one of the allowed lengths or longer than all of them
+ */
+- (BOOL)isAllowedLength:(int)length allowedLengths:(NSArray *)allowedLengths {
+  int maxAllowedLength = 0;
+  if (allowedLengths == nil) {
+    for (int i = 0; i < sizeof(ZX_ITF_DEFAULT_ALLOWED_LENGTHS) / sizeof(int); i++) {
+      if (length == ZX_ITF_DEFAULT_ALLOWED_LENGTHS[i]) {
+        return YES;
+      }
+      maxAllowedLength = MAX(maxAllowedLength, ZX_ITF_DEFAULT_ALLOWED_LENGTHS[i]);
+    }
+  } else {
+    for (NSNumber *i in allowedLengths) {
+      int allowedLength = [i intValue];
+      if (length == allowedLength) {
+        return YES;
+      }
+      maxAllowedLength = MAX(maxAllowedLength, allowedLength);
+    }
+  }
+  return length > maxAllowedLength;
+}
+
 /**
  * @param row          row of black/white values to search
  * @param payloadStart offset of start pattern
@@ -228,16 +243,15 @@ const int ZX_ITF_PATTERNS[ZX_ITF_PATTERNS_LEN][5] = {
   // if there are not so many pixel at all let's try as many as possible
   quietCount = quietCount < startPattern ? quietCount : startPattern;
 
-  for (int i = startPattern - 1; quietCount > 0 && i >= 0; i--) {
-    if ([row get:i]) {
-      break;
-    }
-    quietCount--;
-  }
-  if (quietCount != 0) {
-    return NO;
-  }
-  return YES;
+  return [row isRange:startPattern - quietCount end:startPattern value:NO];
+}
+
+- (BOOL)mayDecodeReversedRow:(ZXBitArray *)row {
+  int patternLength = sizeof(ZX_ITF_ITF_START_PATTERN) / sizeof(int);
+  ZXIntArray *counters = [[ZXIntArray alloc] initWithLength:patternLength];
+  return [ZXOneDReader matchPatternInReverse:row counters:counters matcher:^BOOL(int start, int end) {
+    return [ZXOneDReader patternMatchVariance:counters pattern:ZX_ITF_ITF_START_PATTERN maxIndividualVariance:ZX_ITF_MAX_INDIVIDUAL_VARIANCE] < ZX_ITF_MAX_AVG_VARIANCE;
+  }];
 }
 
 /**
@@ -303,9 +317,15 @@ const int ZX_ITF_PATTERNS[ZX_ITF_PATTERNS_LEN][5] = {
 
   int counterPosition = 0;
   int patternStart = rowOffset;
-  for (int x = rowOffset; x < width; x++) {
+  int runCount;
+  const int32_t *runStarts = [row runStartsWithCount:&runCount];
+  int x = rowOffset;
+  int run = x < width ? [row runIndexAt:x] : runCount;
+  while (x < width) {
     if ([row get:x] ^ isWhite) {
-      array[counterPosition]++;
+      // Count the rest of this run at once
+      array[counterPosition] += runStarts[run + 1] - x;
+      x = runStarts[++run];
     } else {
       if (counterPosition == patternLength - 1) {
         if ([ZXOneDReader patternMatchVariance:counters pattern:pattern maxIndividualVariance:ZX_ITF_MAX_INDIVIDUAL_VARIANCE] < ZX_ITF_MAX_AVG_VARIANCE) {
@@ -321,7 +341,7 @@ const int ZX_ITF_PATTERNS[ZX_ITF_PATTERNS_LEN][5] = {
       } else {
         counterPosition++;
       }
-      array[counterPosition] = 1;
+      array[counterPosition] = 0;
       isWhite = !isWhite;
     }
   }
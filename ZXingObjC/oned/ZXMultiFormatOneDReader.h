@@ -20,6 +20,14 @@
 
 @interface ZXMultiFormatOneDReader : ZXOneDReader
 
+/**
+ * Whether successive decodes are frames of a continuous scan. If so, scanning starts from the
+ * row of the last barcode found and the reader that found it is tried first; rows farther away
+ * and the other readers are only tried on a miss. A decode that finds nothing forgets the row;
+ * reset forgets both. Set from the continuousScan hint.
+ */
+@property (nonatomic, assign) BOOL continuousScan;
+
 - (id)initWithHints:(ZXDecodeHints *)hints;
 
 @end
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#import "ZXBitArray.h"
 #import "ZXCodaBarReader.h"
 #import "ZXCode128Reader.h"
 #import "ZXCode39Reader.h"
@@ -23,20 +24,35 @@
 #import "ZXITFReader.h"
 #import "ZXMultiFormatOneDReader.h"
 #import "ZXMultiFormatUPCEANReader.h"
+#import "ZXOneDPatternFinder.h"
+#import "ZXResult.h"
 #import "ZXRSS14Reader.h"
 #import "ZXRSSExpandedReader.h"
 
 @interface ZXMultiFormatOneDReader ()
 
 @property (nonatomic, strong, readonly) NSMutableArray *readers;
+@property (nonatomic, strong, readonly) ZXOneDPatternFinder *patternFinder;
+@property (nonatomic, assign) int lastResultRow;
+@property (nonatomic, assign) NSUInteger lastReaderIndex;
 
 @end
 
+// The index of the nth reader to try when the one at first goes before all others
+static NSUInteger ZXReaderIndex(NSUInteger n, NSUInteger first) {
+  if (n == 0) {
+    return first;
+  }
+  return n <= first ? n - 1 : n;
+}
+
 @implementation ZXMultiFormatOneDReader
 
 - (id)initWithHints:(ZXDecodeHints *)hints {
   if (self = [super init]) {
     BOOL useCode39CheckDigit = hints != nil && hints.assumeCode39CheckDigit;
+    _continuousScan = hints != nil && hints.continuousScan;
+    _lastResultRow = -1;
     _readers = [NSMutableArray array];
     if (hints != nil) {
       if ([hints containsFormat:kBarcodeFormatEan13] ||
@@ -85,15 +101,48 @@
       [_readers addObject:[[ZXRSS14Reader alloc] init]];
       [_readers addObject:[[ZXRSSExpandedReader alloc] init]];
     }
+
+    // Readers looking for a start pattern of fixed length look for it in one walk of each row
+    _patternFinder = [[ZXOneDPatternFinder alloc] init];
+    for (ZXOneDReader *reader in _readers) {
+      if ([reader conformsToProtocol:@protocol(ZXOneDStartPatternMatcher)]) {
+        [_patternFinder addMatcher:(id<ZXOneDStartPatternMatcher>)reader];
+        reader.sharedPatternFinder = _patternFinder;
+      }
+    }
   }
 
   return self;
 }
 
+- (ZXResult *)decode:(ZXBinaryBitmap *)image hints:(ZXDecodeHints *)hints error:(NSError **)error {
+  ZXResult *result = [super decode:image hints:hints error:error];
+  if (self.continuousScan) {
+    // Rows of a rotated image are no guide to where to start in the next frame
+    NSMutableDictionary *metadata = [result resultMetadata];
+    NSNumber *rowNumber = metadata[@(kResultMetadataTypeRowNumber)];
+    int orientation = [metadata[@(kResultMetadataTypeOrientation)] intValue];
+    self.lastResultRow = rowNumber != nil && orientation % 180 == 0 ? [rowNumber intValue] : -1;
+  }
+  return result;
+}
+
+- (int)startRowForHeight:(int)height {
+  if (self.continuousScan && self.lastResultRow >= 0 && self.lastResultRow < height) {
+    return self.lastResultRow;
+  }
+  return [super startRowForHeight:height];
+}
+
 - (ZXResult *)decodeRow:(int)rowNumber row:(ZXBitArray *)row hints:(ZXDecodeHints *)hints error:(NSError **)error {
-  for (ZXOneDReader *reader in self.readers) {
-    ZXResult *result = [reader decodeRow:rowNumber row:row hints:hints error:error];
+  [self.patternFinder setRow:row];
+  NSUInteger readerCount = [self.readers count];
+  NSUInteger first = self.continuousScan ? self.lastReaderIndex : 0;
+  for (NSUInteger n = 0; n < readerCount; n++) {
+    NSUInteger i = ZXReaderIndex(n, first);
+    ZXResult *result = [self.readers[i] decodeRow:rowNumber row:row hints:hints error:error];
     if (result) {
+      self.lastReaderIndex = i;
       return result;
     }
   }
@@ -102,7 +151,49 @@
   return nil;
 }
 
+- (BOOL)mayDecodeReversedRow:(ZXBitArray *)row {
+  for (ZXOneDReader *reader in self.readers) {
+    if ([reader mayDecodeReversedRow:row]) {
+      return YES;
+    }
+  }
+  return NO;
+}
+
+- (ZXResult *)decodeReversedRow:(int)rowNumber row:(ZXBitArray *)row hints:(ZXDecodeHints *)hints error:(NSError **)error {
+  // Decide which readers to try before reversing the row, while their checks can share its runs
+  NSUInteger readerCount = [self.readers count];
+  BOOL mayDecode[readerCount];
+  BOOL mayDecodeAny = NO;
+  for (NSUInteger i = 0; i < readerCount; i++) {
+    mayDecode[i] = [self.readers[i] mayDecodeReversedRow:row];
+    mayDecodeAny |= mayDecode[i];
+  }
+
+  if (mayDecodeAny) {
+    [row reverse];
+    [self.patternFinder setRow:row];
+    NSUInteger first = self.continuousScan ? self.lastReaderIndex : 0;
+    for (NSUInteger n = 0; n < readerCount; n++) {
+      NSUInteger i = ZXReaderIndex(n, first);
+      if (!mayDecode[i]) {
+        continue;
+      }
+      ZXResult *result = [self.readers[i] decodeRow:rowNumber row:row hints:hints error:error];
+      if (result) {
+        self.lastReaderIndex = i;
+        return result;
+      }
+    }
+  }
+
+  if (error) *error = ZXNotFoundErrorInstance();
+  return nil;
+}
+
 - (void)reset {
+  self.lastResultRow = -1;
+  self.lastReaderIndex = 0;
   for (id<ZXReader> reader in self.readers) {
     [reader reset];
   }
@@ -103,6 +103,10 @@
   return nil;
 }
 
+- (BOOL)mayDecodeReversedRow:(ZXBitArray *)row {
+  return [ZXUPCEANReader hasReversedStartGuardPattern:row];
+}
+
 - (void)reset {
   for (id<ZXReader> reader in self.readers) {
     [reader reset];
@@ -0,0 +1,122 @@
+/*
+ * Copyright 2014 ZXing authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+@class ZXBitArray, ZXOneDPatternFinder;
+
+/**
+ * A reader whose start pattern a ZXOneDPatternFinder looks for.
+ */
+@protocol ZXOneDStartPatternMatcher <NSObject>
+
+/**
+ * @return Number of bars and spaces in the start pattern
+ */
+- (int)startPatternLength;
+
+/**
+ * @return YES if isStartPatternInFinder:run:sortedWidths: needs the widths of each window sorted
+ */
+- (BOOL)needsSortedWidths;
+
+/**
+ * @return Index in the run table of the row of the first bar a start pattern may begin on
+ */
+- (int)firstStartPatternRunInFinder:(ZXOneDPatternFinder *)finder;
+
+/**
+ * @param run index in the run table of the first bar of the window
+ * @param sortedWidths the widths of the window from narrowest to widest, or NULL unless
+ *  needsSortedWidths
+ * @return YES if the window is the start pattern
+ */
+- (BOOL)isStartPatternInFinder:(ZXOneDPatternFinder *)finder run:(int)run sortedWidths:(const int32_t *)sortedWidths;
+
+@optional
+
+/**
+ * Implemented by ZXOneDReader for the readers conforming to this protocol, which call it rather
+ * than implement it. Finds the start pattern in row with the sharedPatternFinder of the reader if
+ * it is on row, otherwise with a finder kept by the reader.
+ *
+ * @return index in the run table of row of the first bar of the start pattern, or -1 if none
+ */
+- (int)startPatternRunInRow:(ZXBitArray *)row;
+
+@end
+
+/**
+ * Slides windows of bars and spaces along a row, a bar and a space at a time, for readers that
+ * look for a start pattern of a fixed number of elements. Widths come straight from the run table
+ * of the row, and are kept sorted for matchers that classify narrow and wide elements so that
+ * they need not search for their threshold.
+ *
+ * All matchers added to a finder are served by a single walk of the row: it starts on the first
+ * query after setRow: and tests every matcher against each window until each has found its start
+ * pattern or run out of row. ZXMultiFormatOneDReader shares one finder between the readers it
+ * enables, so looking for several start patterns costs little more than looking for one.
+ */
+@interface ZXOneDPatternFinder : NSObject
+
+/**
+ * The row being searched.
+ */
+@property (nonatomic, strong, readonly) ZXBitArray *row;
+
+/**
+ * Offsets in the row at which each run starts, followed by the size of the row.
+ */
+@property (nonatomic, assign, readonly) const int32_t *runStarts;
+
+/**
+ * Number of runs in the row.
+ */
+@property (nonatomic, assign, readonly) int runCount;
+
+/**
+ * Widths of the runs in the row, valid while the row is being walked.
+ */
+@property (nonatomic, assign, readonly) const int32_t *widths;
+
+/**
+ * Adds a matcher to test in every walk. Matchers are not retained, as they usually own the finder
+ * or share an owner with it.
+ */
+- (void)addMatcher:(id<ZXOneDStartPatternMatcher>)matcher;
+
+/**
+ * Moves on to a row, forgetting where start patterns were found before. The row must not change
+ * until the next call.
+ */
+- (void)setRow:(ZXBitArray *)row;
+
+/**
+ * @return index in the run table of the first bar of the first window matcher accepts in the
+ *         row, or -1 if there is none
+ */
+- (int)startPatternRunForMatcher:(id<ZXOneDStartPatternMatcher>)matcher;
+
+/**
+ * @return Index in the run table of the first bar starting at or after offset, or runCount if
+ *         there is none
+ */
+- (int)firstBarRunFrom:(int)offset;
+
+/**
+ * @return Width of the white run before run, or 0 if run is the first in the row
+ */
+- (int)whiteBeforeRun:(int)run;
+
+@end
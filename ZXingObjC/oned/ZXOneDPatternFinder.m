@@ -0,0 +1,206 @@
+/*
+ * Copyright 2014 ZXing authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import "ZXBitArray.h"
+#import "ZXOneDPatternFinder.h"
+
+typedef struct {
+  __unsafe_unretained id<ZXOneDStartPatternMatcher> matcher;
+  int length;
+  BOOL needsSortedWidths;
+  // Widths of the window at sortedRun in ascending order, if needsSortedWidths
+  int32_t *sorted;
+  int sortedRun;
+  int firstRun;
+  int result;
+} ZXOneDPatternFinderSlot;
+
+@interface ZXOneDPatternFinder ()
+
+@property (nonatomic, strong) ZXBitArray *row;
+@property (nonatomic, assign) const int32_t *runStarts;
+@property (nonatomic, assign) int runCount;
+@property (nonatomic, assign) int32_t *widthBuffer;
+@property (nonatomic, assign) int widthCapacity;
+@property (nonatomic, assign) ZXOneDPatternFinderSlot *slots;
+@property (nonatomic, assign) int slotCount;
+@property (nonatomic, assign) BOOL scanned;
+
+@end
+
+@implementation ZXOneDPatternFinder
+
+- (void)dealloc {
+  for (int i = 0; i < _slotCount; i++) {
+    free(_slots[i].sorted);
+  }
+  if (_slots != NULL) {
+    free(_slots);
+    _slots = NULL;
+  }
+  if (_widthBuffer != NULL) {
+    free(_widthBuffer);
+    _widthBuffer = NULL;
+  }
+}
+
+- (void)addMatcher:(id<ZXOneDStartPatternMatcher>)matcher {
+  self.slots = (ZXOneDPatternFinderSlot *)realloc(self.slots, (self.slotCount + 1) * sizeof(ZXOneDPatternFinderSlot));
+  ZXOneDPatternFinderSlot *slot = &self.slots[self.slotCount];
+  memset(slot, 0, sizeof(ZXOneDPatternFinderSlot));
+  slot->matcher = matcher;
+  slot->length = [matcher startPatternLength];
+  slot->needsSortedWidths = [matcher needsSortedWidths];
+  if (slot->needsSortedWidths) {
+    slot->sorted = (int32_t *)malloc(slot->length * sizeof(int32_t));
+  }
+  slot->result = -1;
+  self.slotCount++;
+  self.scanned = NO;
+}
+
+- (void)setRow:(ZXBitArray *)row {
+  self.row = row;
+  self.runStarts = NULL;
+  self.runCount = 0;
+  self.scanned = NO;
+}
+
+- (const int32_t *)widths {
+  return self.widthBuffer;
+}
+
+- (int)startPatternRunForMatcher:(id<ZXOneDStartPatternMatcher>)matcher {
+  if (!self.scanned) {
+    [self scan];
+    self.scanned = YES;
+  }
+  for (int i = 0; i < self.slotCount; i++) {
+    if (self.slots[i].matcher == matcher) {
+      return self.slots[i].result;
+    }
+  }
+  return -1;
+}
+
+- (int)firstBarRunFrom:(int)offset {
+  ZXBitArray *row = self.row;
+  if (offset >= row.size) {
+    return self.runCount;
+  }
+  int run = [row runIndexAt:offset];
+  if (run < self.runCount && (self.runStarts[run] < offset || ![row get:self.runStarts[run]])) {
+    run++;
+  }
+  if (run < self.runCount && ![row get:self.runStarts[run]]) {
+    run++;
+  }
+  return run;
+}
+
+- (int)whiteBeforeRun:(int)run {
+  return run > 0 ? self.runStarts[run] - self.runStarts[run - 1] : 0;
+}
+
+/**
+ * Walks the row once, a bar and a space at a time, testing each matcher still looking for its
+ * start pattern against the window beginning on each bar. Bars all have runs of the same parity,
+ * so the first runs of all matchers fall on the same steps.
+ */
+- (void)scan {
+  int runCount;
+  self.runStarts = [self.row runStartsWithCount:&runCount];
+  self.runCount = runCount;
+  if (runCount > self.widthCapacity) {
+    self.widthCapacity = MAX(runCount, self.widthCapacity * 2);
+    self.widthBuffer = (int32_t *)realloc(self.widthBuffer, self.widthCapacity * sizeof(int32_t));
+  }
+  const int32_t *runStarts = self.runStarts;
+  int32_t *widths = self.widthBuffer;
+  for (int i = 0; i < runCount; i++) {
+    widths[i] = runStarts[i + 1] - runStarts[i];
+  }
+
+  ZXOneDPatternFinderSlot *slots = self.slots;
+  int slotCount = self.slotCount;
+  int firstRun = runCount;
+  for (int i = 0; i < slotCount; i++) {
+    slots[i].firstRun = [slots[i].matcher firstStartPatternRunInFinder:self];
+    slots[i].sortedRun = -1;
+    slots[i].result = -1;
+    firstRun = MIN(firstRun, slots[i].firstRun);
+  }
+
+  for (int run = firstRun; ; run += 2) {
+    BOOL searching = NO;
+    for (int i = 0; i < slotCount; i++) {
+      ZXOneDPatternFinderSlot *slot = &slots[i];
+      // There must always be another element after the window
+      if (slot->result != -1 || run + slot->length >= runCount) {
+        continue;
+      }
+      searching = YES;
+      if (run < slot->firstRun) {
+        continue;
+      }
+      if (slot->needsSortedWidths) {
+        [self sortWindowOfSlot:slot run:run];
+      }
+      if ([slot->matcher isStartPatternInFinder:self run:run sortedWidths:slot->sorted]) {
+        slot->result = run;
+      }
+    }
+    if (!searching) {
+      break;
+    }
+  }
+}
+
+- (void)sortWindowOfSlot:(ZXOneDPatternFinderSlot *)slot run:(int)run {
+  const int32_t *widths = self.widthBuffer;
+  int length = slot->length;
+  int32_t *sorted = slot->sorted;
+  if (slot->sortedRun != run - 2) {
+    for (int i = 0; i < length; i++) {
+      // Insertion sort; windows are only about ten elements long
+      int width = widths[run + i];
+      int j = i;
+      for (; j > 0 && sorted[j - 1] > width; j--) {
+        sorted[j] = sorted[j - 1];
+      }
+      sorted[j] = width;
+    }
+  } else {
+    // Drop the bar and space that left the window and add the two that entered it
+    for (int k = 0; k < 2; k++) {
+      int left = widths[run - 2 + k];
+      int i = 0;
+      while (sorted[i] != left) {
+        i++;
+      }
+      memmove(sorted + i, sorted + i + 1, (length - 1 - i) * sizeof(int32_t));
+      int width = widths[run + length - 2 + k];
+      int j = length - 1;
+      for (; j > 0 && sorted[j - 1] > width; j--) {
+        sorted[j] = sorted[j - 1];
+      }
+      sorted[j] = width;
+    }
+  }
+  slot->sortedRun = run;
+}
+
+@end
@@ -19,17 +19,106 @@
 extern const int ZX_ONED_INTEGER_MATH_SHIFT;
 extern const int ZX_ONED_PATTERN_MATCH_RESULT_SCALE_FACTOR;
 
-@class ZXBitArray, ZXDecodeHints, ZXIntArray, ZXResult;
+@class ZXBitArray, ZXDecodeHints, ZXIntArray, ZXOneDPatternFinder, ZXResult;
 
 /**
  * Encapsulates functionality and implementation that is common to all families
  * of one-dimensional barcodes.
+ *
+ * Readers keep scratch buffers, counters and, for stacked symbols, rows seen so far, so an
+ * instance must only be used by one thread at a time.
  */
 @interface ZXOneDReader : NSObject <ZXReader>
 
+/**
+ * @return The number of rows this reader skipped without decoding because they failed the
+ *         minimumRowTransitions and maximumRowRunRatio checks of the hints.
+ */
+@property (nonatomic, readonly) int rejectedRowCount;
+
+/**
+ * @return The number of rows this reader attempted to decode.
+ */
+@property (nonatomic, readonly) int decodedRowCount;
+
+/**
+ * A finder shared with other readers, which looks for the start pattern of this reader along with
+ * theirs in one walk of each row. Set by ZXMultiFormatOneDReader, which moves the finder on to each
+ * row before decoding it. Readers without one use a finder of their own.
+ */
+@property (nonatomic, weak) ZXOneDPatternFinder *sharedPatternFinder;
+
 + (BOOL)recordPattern:(ZXBitArray *)row start:(int)start counters:(ZXIntArray *)counters;
 + (BOOL)recordPatternInReverse:(ZXBitArray *)row start:(int)start counters:(ZXIntArray *)counters;
+
+/**
+ * Looks for a pattern as it would be found in row reversed, without reversing row. A window of
+ * counters.length runs is slid from the end of row towards its start, each window beginning on
+ * a black run, and its widths are recorded in counters last run first. matcher is called with the
+ * bounds of each window in row, start inclusive and end exclusive.
+ *
+ * @return YES as soon as matcher returns YES for a window, NO if it never does
+ */
++ (BOOL)matchPatternInReverse:(ZXBitArray *)row counters:(ZXIntArray *)counters matcher:(BOOL (^)(int start, int end))matcher;
+
+/**
+ * Cheap check, from the run table of row, that row could hold a 1D barcode at all: it must have a
+ * stretch of consecutive bars and spaces bounded by at least minimumTransitions transitions, whose
+ * widest is at most maximumRunRatio times its narrowest. A maximumRunRatio of 0 only counts
+ * transitions.
+ */
++ (BOOL)mayContainBarcode:(ZXBitArray *)row minimumTransitions:(int)minimumTransitions maximumRunRatio:(float)maximumRunRatio;
+
+/**
+ * Finds the pattern nearest to counters by rounding each counter to a whole number of modules
+ * and looking the widths up, rather than matching every pattern with patternMatchVariance:. All
+ * patterns must be patternLength modules wide with elements 1 to 4 modules wide. lookup is indexed
+ * by the widths of a pattern less one, two bits each with the first counter lowest, and holds
+ * its index or -1.
+ *
+ * The nearest pattern is also the one patternMatchVariance: scores best, but only if it is
+ * nearer than all others by more than that score's rounding; when widths lie about halfway
+ * between modules, or do not round to a pattern, the lookup is inconclusive and callers should
+ * fall back to matching.
+ *
+ * @param pattern set to the index of the nearest pattern, or -1 if counters are narrower than
+ *  patternLength
+ * @param variance set to the variance of counters from that pattern, as patternMatchVariance:
+ *  would compute it
+ * @return YES if pattern and variance were set
+ */
++ (BOOL)lookupPattern:(ZXIntArray *)counters patternLength:(int)patternLength lookup:(const int8_t *)lookup maxIndividualVariance:(int)maxIndividualVariance pattern:(int *)pattern variance:(int *)variance;
+
 + (int)patternMatchVariance:(ZXIntArray *)counters pattern:(const int[])pattern maxIndividualVariance:(int)maxIndividualVariance;
 - (ZXResult *)decodeRow:(int)rowNumber row:(ZXBitArray *)row hints:(ZXDecodeHints *)hints error:(NSError **)error;
 
+/**
+ * The row scanned first, before moving alternately above and below it. The default is the
+ * middle row of the image.
+ *
+ * @param height height of the image being scanned
+ */
+- (int)startRowForHeight:(int)height;
+
+/**
+ * Whether decodeRow: could find a barcode in row once row is reversed. The default is YES;
+ * readers whose start pattern tells which way round it is read override this to look for that
+ * pattern from the end of row, so rows without it are not reversed and decoded again.
+ *
+ * @param row the row as read left to right
+ */
+- (BOOL)mayDecodeReversedRow:(ZXBitArray *)row;
+
+/**
+ * Attempts to decode row read right to left. row is reversed in place first, unless no barcode
+ * could be found in it that way, according to mayDecodeReversedRow:.
+ *
+ * @param rowNumber row number from top of the row
+ * @param row the row as read left to right
+ * @param hints decode hints
+ * @return ZXResult containing encoded string and start/end of barcode in the reversed row or nil
+ *  if an error occurs or barcode cannot be found
+ */
+- (ZXResult *)decodeReversedRow:(int)rowNumber row:(ZXBitArray *)row hints:(ZXDecodeHints *)hints error:(NSError **)error;
+
 @end
@@ -16,9 +16,11 @@
 
 #import "ZXBinaryBitmap.h"
 #import "ZXBitArray.h"
+#import "ZXCancellationToken.h"
 #import "ZXDecodeHints.h"
 #import "ZXErrors.h"
 #import "ZXIntArray.h"
+#import "ZXOneDPatternFinder.h"
 #import "ZXOneDReader.h"
 #import "ZXResult.h"
 #import "ZXResultPoint.h"
@@ -26,6 +28,17 @@
 const int ZX_ONED_INTEGER_MATH_SHIFT = 8;
 const int ZX_ONED_PATTERN_MATCH_RESULT_SCALE_FACTOR = 1 << ZX_ONED_INTEGER_MATH_SHIFT;
 
+@interface ZXOneDReader ()
+
+@property (nonatomic, assign) int rejectedRowCount;
+@property (nonatomic, assign) int decodedRowCount;
+@property (nonatomic, strong) ZXOneDPatternFinder *patternFinder;
+
+// Declared for subclasses by ZXOneDStartPatternMatcher
+- (int)startPatternRunInRow:(ZXBitArray *)row;
+
+@end
+
 @implementation ZXOneDReader
 
 - (ZXResult *)decode:(ZXBinaryBitmap *)image error:(NSError **)error {
@@ -40,7 +53,7 @@ const int ZX_ONED_PATTERN_MATCH_RESULT_SCALE_FACTOR = 1 << ZX_ONED_INTEGER_MATH_
     return result;
   } else if (decodeError.code == ZXNotFoundError) {
     BOOL tryHarder = hints != nil && hints.tryHarder;
-    if (tryHarder && [image rotateSupported]) {
+    if (tryHarder && [image rotateSupported] && !hints.cancellationToken.isCancelled) {
       ZXBinaryBitmap *rotatedImage = [image rotateCounterClockwise];
       ZXResult *result = [self doDecode:rotatedImage hints:hints error:error];
       if (!result) {
@@ -79,7 +92,9 @@ const int ZX_ONED_PATTERN_MATCH_RESULT_SCALE_FACTOR = 1 << ZX_ONED_INTEGER_MATH_
  * We're going to examine rows from the middle outward, searching alternately above and below the
  * middle, and farther out each time. rowStep is the number of rows between each successive
  * attempt above and below the middle. So we'd scan row middle, then middle - rowStep, then
- * middle + rowStep, then middle - (2 * rowStep), etc.
+ * middle + rowStep, then middle - (2 * rowStep), etc. Subclasses may start from another row
+ * than the middle through startRowForHeight:; once one side runs off the image, the other
+ * side carries on alone.
  * rowStep is bigger as the image is taller, but is always at least 1. We've somewhat arbitrarily
  * decided that moving up and down by about 1/16 of the image is pretty good; we try more of the
  * image if "trying harder".
@@ -92,8 +107,10 @@ const int ZX_ONED_PATTERN_MATCH_RESULT_SCALE_FACTOR = 1 << ZX_ONED_INTEGER_MATH_
   int width = image.width;
   int height = image.height;
   ZXBitArray *row = [[ZXBitArray alloc] initWithSize:width];
-  int middle = height >> 1;
+  int middle = [self startRowForHeight:height];
   BOOL tryHarder = hints != nil && hints.tryHarder;
+  int minimumTransitions = hints != nil ? hints.minimumRowTransitions : 0;
+  float maximumRunRatio = hints != nil ? hints.maximumRowRunRatio : 0;
   int rowStep = MAX(1, height >> (tryHarder ? 8 : 5));
   int maxLines;
   if (tryHarder) {
@@ -102,13 +119,18 @@ const int ZX_ONED_PATTERN_MATCH_RESULT_SCALE_FACTOR = 1 << ZX_ONED_INTEGER_MATH_
     maxLines = 15;
   }
 
-  for (int x = 0; x < maxLines; x++) {
+  ZXCancellationToken *cancellationToken = hints.cancellationToken;
+  for (int x = 0, linesLeft = maxLines; linesLeft > 0 && !cancellationToken.isCancelled; x++) {
     int rowStepsAboveOrBelow = (x + 1) >> 1;
     BOOL isAbove = (x & 0x01) == 0;
     int rowNumber = middle + rowStep * (isAbove ? rowStepsAboveOrBelow : -rowStepsAboveOrBelow);
     if (rowNumber < 0 || rowNumber >= height) {
-      break;
+      if (middle - rowStep * rowStepsAboveOrBelow < 0 && middle + rowStep * rowStepsAboveOrBelow >= height) {
+        break;
+      }
+      continue;
     }
+    linesLeft--;
 
     NSError *rowError = nil;
     row = [image blackRow:rowNumber row:row error:&rowError];
@@ -119,17 +141,27 @@ const int ZX_ONED_PATTERN_MATCH_RESULT_SCALE_FACTOR = 1 << ZX_ONED_INTEGER_MATH_
       return nil;
     }
 
+    if (minimumTransitions > 0 &&
+        ![ZXOneDReader mayContainBarcode:row minimumTransitions:minimumTransitions maximumRunRatio:maximumRunRatio]) {
+      self.rejectedRowCount++;
+      continue;
+    }
+    self.decodedRowCount++;
+
     for (int attempt = 0; attempt < 2; attempt++) {
-      if (attempt == 1) {
-        [row reverse];
+      ZXResult *result;
+      if (attempt == 0) {
+        result = [self decodeRow:rowNumber row:row hints:hints error:nil];
+      } else {
         if (hints != nil && hints.resultPointCallback) {
           hints = [hints copy];
           hints.resultPointCallback = nil;
         }
+        result = [self decodeReversedRow:rowNumber row:row hints:hints error:nil];
       }
 
-      ZXResult *result = [self decodeRow:rowNumber row:row hints:hints error:nil];
       if (result) {
+        [result putMetadata:kResultMetadataTypeRowNumber value:@(rowNumber)];
         if (attempt == 1) {
           [result putMetadata:kResultMetadataTypeOrientation value:@180];
           NSMutableArray *points = [result resultPoints];
@@ -169,44 +201,153 @@ const int ZX_ONED_PATTERN_MATCH_RESULT_SCALE_FACTOR = 1 << ZX_ONED_INTEGER_MATH_
   if (start >= end) {
     return NO;
   }
-  BOOL isWhite = ![row get:start];
-  int counterPosition = 0;
-  int i = start;
-
-  while (i < end) {
-    if ([row get:i] ^ isWhite) {
-      array[counterPosition]++;
-    } else {
-      counterPosition++;
-      if (counterPosition == numCounters) {
-        break;
-      } else {
-        array[counterPosition] = 1;
-        isWhite = !isWhite;
-      }
-    }
-    i++;
-  }
 
-  if (!(counterPosition == numCounters || (counterPosition == numCounters - 1 && i == end))) {
+  // The first counter is the rest of the run containing start, the others are the runs after it.
+  // The last one may run to the end of the row.
+  int runCount;
+  const int32_t *runStarts = [row runStartsWithCount:&runCount];
+  int run = [row runIndexAt:start];
+  if (runCount - run < numCounters) {
     return NO;
   }
+  array[0] = runStarts[run + 1] - start;
+  for (int i = 1; i < numCounters; i++) {
+    array[i] = runStarts[run + i + 1] - runStarts[run + i];
+  }
   return YES;
 }
 
 + (BOOL)recordPatternInReverse:(ZXBitArray *)row start:(int)start counters:(ZXIntArray *)counters {
-  int numTransitionsLeft = counters.length;
-  BOOL last = [row get:start];
-  while (start > 0 && numTransitionsLeft >= 0) {
-    if ([row get:--start] != last) {
-      numTransitionsLeft--;
-      last = !last;
+  // The pattern starts at the run numCounters runs before the one containing start, and there must
+  // be a run before that one too
+  int numCounters = counters.length;
+  int runCount;
+  const int32_t *runStarts = [row runStartsWithCount:&runCount];
+  int run = [row runIndexAt:start];
+  if (run <= numCounters || ![self recordPattern:row start:runStarts[run - numCounters] counters:counters]) {
+    return NO;
+  }
+  return YES;
+}
+
++ (BOOL)matchPatternInReverse:(ZXBitArray *)row counters:(ZXIntArray *)counters matcher:(BOOL (^)(int start, int end))matcher {
+  int numCounters = counters.length;
+  int32_t *array = counters.array;
+  int runCount;
+  const int32_t *runStarts = [row runStartsWithCount:&runCount];
+  int run = runCount - 1;
+  if (run >= 0 && ![row get:runStarts[run]]) {
+    run--;
+  }
+  for (; run >= numCounters - 1; run -= 2) {
+    for (int i = 0; i < numCounters; i++) {
+      array[i] = runStarts[run - i + 1] - runStarts[run - i];
     }
+    if (matcher(runStarts[run - numCounters + 1], runStarts[run + 1])) {
+      return YES;
+    }
+  }
+  return NO;
+}
+
+- (int)startPatternRunInRow:(ZXBitArray *)row {
+  id<ZXOneDStartPatternMatcher> matcher = (id<ZXOneDStartPatternMatcher>)self;
+  ZXOneDPatternFinder *finder = self.sharedPatternFinder;
+  if (finder.row != row) {
+    if (!self.patternFinder) {
+      self.patternFinder = [[ZXOneDPatternFinder alloc] init];
+      [self.patternFinder addMatcher:matcher];
+    }
+    finder = self.patternFinder;
+    [finder setRow:row];
   }
+  return [finder startPatternRunForMatcher:matcher];
+}
 
-  if (numTransitionsLeft >= 0 || ![self recordPattern:row start:start + 1 counters:counters]) {
++ (BOOL)mayContainBarcode:(ZXBitArray *)row minimumTransitions:(int)minimumTransitions maximumRunRatio:(float)maximumRunRatio {
+  int runCount;
+  const int32_t *runStarts = [row runStartsWithCount:&runCount];
+  if (runCount - 1 < minimumTransitions) {
     return NO;
   }
+  if (maximumRunRatio <= 0 || minimumTransitions <= 1) {
+    return YES;
+  }
+
+  // Look for minimumTransitions - 1 consecutive runs, not counting the first and last ones which
+  // are cut off by the row ends, whose widths are all within maximumRunRatio of each other
+  int needed = minimumTransitions - 1;
+  for (int first = 1; first + needed < runCount; first++) {
+    int narrowest = INT_MAX;
+    int widest = 0;
+    int run = first;
+    for (; run < first + needed; run++) {
+      int width = runStarts[run + 1] - runStarts[run];
+      narrowest = MIN(narrowest, width);
+      widest = MAX(widest, width);
+      if (widest > narrowest * maximumRunRatio) {
+        break;
+      }
+    }
+    if (run == first + needed) {
+      return YES;
+    }
+  }
+  return NO;
+}
+
++ (BOOL)lookupPattern:(ZXIntArray *)counters patternLength:(int)patternLength lookup:(const int8_t *)lookup maxIndividualVariance:(int)maxIndividualVariance pattern:(int *)pattern variance:(int *)variance {
+  int numCounters = counters.length;
+  int32_t *array = counters.array;
+  int total = 0;
+  for (int i = 0; i < numCounters; i++) {
+    total += array[i];
+  }
+  if (total < patternLength) {
+    *pattern = -1;
+    *variance = INT_MAX;
+    return YES;
+  }
+
+  // Each counter is nearest to one multiple of the module, in the same fixed point as
+  // patternMatchVariance:. Moving it to another costs at least the slack between the two, and any
+  // other pattern of the same length has to move at least two counters.
+  int unitBarWidth = (total << ZX_ONED_INTEGER_MATH_SHIFT) / patternLength;
+  maxIndividualVariance = (maxIndividualVariance * unitBarWidth) >> ZX_ONED_INTEGER_MATH_SHIFT;
+  int key = 0;
+  int modules = 0;
+  int totalVariance = 0;
+  int leastSlack = INT_MAX;
+  int nextLeastSlack = INT_MAX;
+  for (int i = 0; i < numCounters; i++) {
+    int counter = array[i] << ZX_ONED_INTEGER_MATH_SHIFT;
+    int width = (2 * counter + unitBarWidth) / (2 * unitBarWidth);
+    if (width < 1 || width > 4) {
+      return NO;
+    }
+    int scaledPattern = width * unitBarWidth;
+    int delta = counter > scaledPattern ? counter - scaledPattern : scaledPattern - counter;
+    if (delta > maxIndividualVariance) {
+      return NO;
+    }
+    int slack = unitBarWidth - 2 * delta;
+    if (slack < leastSlack) {
+      nextLeastSlack = leastSlack;
+      leastSlack = slack;
+    } else if (slack < nextLeastSlack) {
+      nextLeastSlack = slack;
+    }
+    key |= (width - 1) << (i << 1);
+    modules += width;
+    totalVariance += delta;
+  }
+
+  // Variances are compared after dividing by total, so the nearest pattern has to win by that much
+  if (modules != patternLength || lookup[key] < 0 || leastSlack + nextLeastSlack < total) {
+    return NO;
+  }
+  *pattern = lookup[key];
+  *variance = totalVariance / total;
   return YES;
 }
 
@@ -270,4 +411,21 @@ const int ZX_ONED_PATTERN_MATCH_RESULT_SCALE_FACTOR = 1 << ZX_ONED_INTEGER_MATH_
                                userInfo:nil];
 }
 
+- (int)startRowForHeight:(int)height {
+  return height >> 1;
+}
+
+- (BOOL)mayDecodeReversedRow:(ZXBitArray *)row {
+  return YES;
+}
+
+- (ZXResult *)decodeReversedRow:(int)rowNumber row:(ZXBitArray *)row hints:(ZXDecodeHints *)hints error:(NSError **)error {
+  if (![self mayDecodeReversedRow:row]) {
+    if (error) *error = ZXNotFoundErrorInstance();
+    return nil;
+  }
+  [row reverse];
+  return [self decodeRow:rowNumber row:row hints:hints error:error];
+}
+
 @end
@@ -43,6 +43,12 @@ extern const int ZX_UPC_EAN_L_AND_G_PATTERNS[][4];
 
 + (NSRange)findStartGuardPattern:(ZXBitArray *)row error:(NSError **)error;
 
+/**
+ * Looks for a start guard pattern, and the quiet zone before it, as it would be found in row
+ * reversed, without reversing row.
+ */
++ (BOOL)hasReversedStartGuardPattern:(ZXBitArray *)row;
+
 /**
  * Like decodeRow:row:hints:, but allows caller to inform method about where the UPC/EAN start pattern is
  * found. This allows this to be computed once and reused across many implementations.
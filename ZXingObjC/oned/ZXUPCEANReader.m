@@ -86,6 +86,11 @@ const int ZX_UPC_EAN_L_AND_G_PATTERNS[ZX_UPC_EAN_L_AND_G_PATTERNS_LEN][ZX_UPC_EA
   {2, 1, 1, 3}  // 19 reversed 9
 };
 
+/**
+ * Index of each "L" and "G" pattern by its widths less one, two bits each, or -1.
+ */
+static int8_t ZX_UPC_EAN_L_AND_G_LOOKUP[1 << 8];
+
 @interface ZXUPCEANReader ()
 
 @property (nonatomic, strong, readonly) NSMutableString *decodeRowNSMutableString;
@@ -99,6 +104,18 @@ const int ZX_UPC_EAN_L_AND_G_PATTERNS[ZX_UPC_EAN_L_AND_G_PATTERNS_LEN][ZX_UPC_EA
 + (void)initialize {
   ZX_UPC_EAN_MAX_AVG_VARIANCE = (int)(ZX_ONED_PATTERN_MATCH_RESULT_SCALE_FACTOR * 0.48f);
   ZX_UPC_EAN_MAX_INDIVIDUAL_VARIANCE = (int)(ZX_ONED_PATTERN_MATCH_RESULT_SCALE_FACTOR * 0.7f);
+
+  if (self != [ZXUPCEANReader class]) {
+    return;
+  }
+  memset(ZX_UPC_EAN_L_AND_G_LOOKUP, -1, sizeof(ZX_UPC_EAN_L_AND_G_LOOKUP));
+  for (int i = 0; i < ZX_UPC_EAN_L_AND_G_PATTERNS_LEN; i++) {
+    int key = 0;
+    for (int j = 0; j < ZX_UPC_EAN_L_AND_G_PATTERNS_SUB_LEN; j++) {
+      key |= (ZX_UPC_EAN_L_AND_G_PATTERNS[i][j] - 1) << (j << 1);
+    }
+    ZX_UPC_EAN_L_AND_G_LOOKUP[key] = i;
+  }
 }
 
 - (id)init {
@@ -140,6 +157,20 @@ const int ZX_UPC_EAN_L_AND_G_PATTERNS[ZX_UPC_EAN_L_AND_G_PATTERNS_LEN][ZX_UPC_EA
   return startRange;
 }
 
++ (BOOL)hasReversedStartGuardPattern:(ZXBitArray *)row {
+  ZXIntArray *counters = [[ZXIntArray alloc] initWithLength:ZX_UPC_EAN_START_END_PATTERN_LEN];
+  return [ZXOneDReader matchPatternInReverse:row counters:counters matcher:^BOOL(int start, int end) {
+    int quietEnd = end + (end - start);
+    return quietEnd <= row.size &&
+      [self patternMatchVariance:counters pattern:ZX_UPC_EAN_START_END_PATTERN maxIndividualVariance:ZX_UPC_EAN_MAX_INDIVIDUAL_VARIANCE] < ZX_UPC_EAN_MAX_AVG_VARIANCE &&
+      [row isRange:end end:quietEnd value:NO];
+  }];
+}
+
+- (BOOL)mayDecodeReversedRow:(ZXBitArray *)row {
+  return [ZXUPCEANReader hasReversedStartGuardPattern:row];
+}
+
 - (ZXResult *)decodeRow:(int)rowNumber row:(ZXBitArray *)row hints:(ZXDecodeHints *)hints error:(NSError **)error {
   return [self decodeRow:rowNumber row:row startGuardRange:[[self class] findStartGuardPattern:row error:error] hints:hints error:error];
 }
@@ -292,9 +323,15 @@ const int ZX_UPC_EAN_L_AND_G_PATTERNS[ZX_UPC_EAN_L_AND_G_PATTERNS_LEN][ZX_UPC_EA
   int counterPosition = 0;
   int patternStart = rowOffset;
   int32_t *array = counters.array;
-  for (int x = rowOffset; x < width; x++) {
+  int runCount;
+  const int32_t *runStarts = [row runStartsWithCount:&runCount];
+  int x = rowOffset;
+  int run = x < width ? [row runIndexAt:x] : runCount;
+  while (x < width) {
     if ([row get:x] ^ isWhite) {
-      array[counterPosition]++;
+      // Count the rest of this run at once
+      array[counterPosition] += runStarts[run + 1] - x;
+      x = runStarts[++run];
     } else {
       if (counterPosition == patternLength - 1) {
         if ([self patternMatchVariance:counters pattern:pattern maxIndividualVariance:ZX_UPC_EAN_MAX_INDIVIDUAL_VARIANCE] < ZX_UPC_EAN_MAX_AVG_VARIANCE) {
@@ -312,7 +349,7 @@ const int ZX_UPC_EAN_L_AND_G_PATTERNS[ZX_UPC_EAN_L_AND_G_PATTERNS_LEN][ZX_UPC_EA
       } else {
         counterPosition++;
       }
-      array[counterPosition] = 1;
+      array[counterPosition] = 0;
       isWhite = !isWhite;
     }
   }
@@ -331,6 +368,20 @@ const int ZX_UPC_EAN_L_AND_G_PATTERNS[ZX_UPC_EAN_L_AND_G_PATTERNS_LEN][ZX_UPC_EA
   }
   int bestVariance = ZX_UPC_EAN_MAX_AVG_VARIANCE;
   int bestMatch = -1;
+
+  // When the digit is clearly nearest one of all the patterns, no other can match better. Only an
+  // "L" digit nearest a "G" pattern still needs the "L" patterns matched.
+  int nearest;
+  int nearestVariance;
+  if ([self lookupPattern:counters patternLength:7 lookup:ZX_UPC_EAN_L_AND_G_LOOKUP maxIndividualVariance:ZX_UPC_EAN_MAX_INDIVIDUAL_VARIANCE pattern:&nearest variance:&nearestVariance] &&
+      (nearestVariance >= bestVariance || patternType == ZX_UPC_EAN_PATTERNS_L_AND_G_PATTERNS || nearest < ZX_UPC_EAN_L_PATTERNS_LEN)) {
+    if (nearestVariance < bestVariance) {
+      return nearest;
+    }
+    if (error) *error = ZXNotFoundErrorInstance();
+    return -1;
+  }
+
   int max = 0;
   switch (patternType) {
     case ZX_UPC_EAN_PATTERNS_L_PATTERNS:
@@ -38,6 +38,7 @@
 #import "ZXMultiFormatOneDReader.h"
 #import "ZXMultiFormatUPCEANReader.h"
 #import "ZXOneDimensionalCodeWriter.h"
+#import "ZXOneDPatternFinder.h"
 #import "ZXOneDReader.h"
 #import "ZXRSS14Reader.h"
 #import "ZXRSSDataCharacter.h"
@@ -277,9 +277,15 @@ const int ZX_RSS14_INSIDE_ODD_WIDEST[4] = {2,4,6,8};
 
   int counterPosition = 0;
   int patternStart = rowOffset;
-  for (int x = rowOffset; x < width; x++) {
+  int runCount;
+  const int32_t *runStarts = [row runStartsWithCount:&runCount];
+  int x = rowOffset;
+  int run = x < width ? [row runIndexAt:x] : runCount;
+  while (x < width) {
     if ([row get:x] ^ isWhite) {
-      array[counterPosition]++;
+      // Count the rest of this run at once
+      array[counterPosition] += runStarts[run + 1] - x;
+      x = runStarts[++run];
     } else {
       if (counterPosition == 3) {
         if ([ZXAbstractRSSReader isFinderPattern:counters]) {
@@ -294,7 +300,7 @@ const int ZX_RSS14_INSIDE_ODD_WIDEST[4] = {2,4,6,8};
       } else {
         counterPosition++;
       }
-      array[counterPosition] = 1;
+      array[counterPosition] = 0;
       isWhite = !isWhite;
     }
   }
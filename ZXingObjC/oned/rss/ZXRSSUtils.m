@@ -17,8 +17,30 @@
 #import "ZXIntArray.h"
 #import "ZXRSSUtils.h"
 
+#define ZX_RSS_COMBINS_LEN 32
+
+/**
+ * Binomial coefficients: ZX_RSS_COMBINS[n][r] is the number of ways to choose r of n, 0 if r > n.
+ */
+static int ZX_RSS_COMBINS[ZX_RSS_COMBINS_LEN][ZX_RSS_COMBINS_LEN];
+
+// The sum of combins(a, r) for a from 0 to hi, which is combins(hi + 1, r + 1)
+static int ZXRSSCombinsSum(int hi, int r) {
+  return hi < 0 ? 0 : ZX_RSS_COMBINS[hi + 1][r + 1];
+}
+
 @implementation ZXRSSUtils
 
++ (void)initialize {
+  // Pascal's triangle
+  for (int n = 0; n < ZX_RSS_COMBINS_LEN; n++) {
+    ZX_RSS_COMBINS[n][0] = 1;
+    for (int r = 1; r < ZX_RSS_COMBINS_LEN; r++) {
+      ZX_RSS_COMBINS[n][r] = n == 0 ? 0 : ZX_RSS_COMBINS[n - 1][r - 1] + ZX_RSS_COMBINS[n - 1][r];
+    }
+  }
+}
+
 /*
 + (NSArray *)rssWidths:(int)val n:(int)n elements:(int)elements maxWidth:(int)maxWidth noNarrow:(BOOL)noNarrow {
   NSMutableArray *widths = [NSMutableArray arrayWithCapacity:elements];
@@ -60,6 +82,50 @@
 */
 
 + (int)rssValue:(ZXIntArray *)widths maxWidth:(int)maxWidth noNarrow:(BOOL)noNarrow {
+  int elements = widths.length;
+  int32_t *array = widths.array;
+  int n = 0;
+  for (int i = 0; i < elements; i++) {
+    if (array[i] < 1) {
+      return [self rssValueByCounting:widths maxWidth:maxWidth noNarrow:noNarrow];
+    }
+    n += array[i];
+  }
+  if (n >= ZX_RSS_COMBINS_LEN - 1) {
+    return [self rssValueByCounting:widths maxWidth:maxWidth noNarrow:noNarrow];
+  }
+
+  // rssValueByCounting: adds up terms for every width below that of each element. Each kind of
+  // term is combins(a, r) over a run of consecutive a, which is a difference of two table sums.
+  int val = 0;
+  BOOL narrowBefore = NO;
+  for (int bar = 0; bar < elements - 1; bar++) {
+    int width = array[bar];
+    int r = elements - bar - 2;
+    val += ZXRSSCombinsSum(n - 2, r) - ZXRSSCombinsSum(n - width - 1, r);
+    if (noNarrow && !narrowBefore) {
+      int widest = MIN(width - 1, n - 2 * r - 2);
+      if (widest >= 2) {
+        val -= ZXRSSCombinsSum(n - r - 4, r) - ZXRSSCombinsSum(n - widest - r - 3, r);
+      }
+    }
+    if (r > 0) {
+      val -= (r + 1) * (ZXRSSCombinsSum(n - maxWidth - 2, r) - ZXRSSCombinsSum(n - width - maxWidth - 1, r));
+    } else {
+      val -= MAX(0, MIN(width - 1, n - maxWidth - 1));
+    }
+    if (width == 1) {
+      narrowBefore = YES;
+    }
+    n -= width;
+  }
+  return val;
+}
+
+/**
+ * The listing of ISO/IEC 24724 as is, for widths the tables do not cover.
+ */
++ (int)rssValueByCounting:(ZXIntArray *)widths maxWidth:(int)maxWidth noNarrow:(BOOL)noNarrow {
   int elements = widths.length;
   int n = 0;
   for (int i = 0; i < elements; i++) {
@@ -22,6 +22,28 @@
 
 @property (nonatomic, strong, readonly) NSMutableArray *rows;
 
+/**
+ * The maximum number of distinct rows kept for assembling a stacked symbol. When more rows
+ * than this are stored they are all discarded. Defaults to 25.
+ */
+@property (nonatomic, assign) int maximumStoredRows;
+
+/**
+ * The maximum number of row combinations evaluated by one attempt to assemble a stacked
+ * symbol from the stored rows, or 0 for no limit. Defaults to 10000.
+ */
+@property (nonatomic, assign) int maximumRowCombinations;
+
+/**
+ * @return The number of rows this reader has stored for stacked decoding.
+ */
+@property (nonatomic, readonly) int storedRowCount;
+
+/**
+ * @return The number of row combinations this reader has evaluated while assembling stacked symbols.
+ */
+@property (nonatomic, readonly) int evaluatedCombinationCount;
+
 - (ZXRSSDataCharacter *)decodeDataCharacter:(ZXBitArray *)row pattern:(ZXRSSFinderPattern *)pattern isOddPattern:(BOOL)isOddPattern leftChar:(BOOL)leftChar;
 
 @end
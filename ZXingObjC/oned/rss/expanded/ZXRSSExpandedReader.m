@@ -79,12 +79,102 @@ const int ZX_FINDER_PATTERN_SEQUENCES[ZX_FINDER_PATTERN_SEQUENCES_LEN][ZX_FINDER
   { ZX_FINDER_PAT_A, ZX_FINDER_PAT_A, ZX_FINDER_PAT_B, ZX_FINDER_PAT_B, ZX_FINDER_PAT_C, ZX_FINDER_PAT_D, ZX_FINDER_PAT_D, ZX_FINDER_PAT_E, ZX_FINDER_PAT_E, ZX_FINDER_PAT_F, ZX_FINDER_PAT_F },
 };
 
+#define ZX_RSS_EXPANDED_MAX_STORED_ROWS 25
+#define ZX_RSS_EXPANDED_MAX_ROW_COMBINATIONS 10000
+#define ZX_RSS_EXPANDED_ALL_SEQUENCES ((1 << ZX_FINDER_PATTERN_SEQUENCES_LEN) - 1)
+
+// What the stacked assembly needs to know about a stored row
+typedef struct {
+  int pairCount;
+  int finderValues[ZX_FINDER_PATTERN_SEQUENCES_SUBLEN];
+  int checksum;
+  int characterCount;
+  int checkPortion;
+  int checkValue;
+  BOOL hasFirstCharacter;
+} ZXRSSExpandedRowSummary;
+
+// A partial stacked assembly: the finder pattern sequences it may still become and its checksum state
+typedef struct {
+  int pairCount;
+  int sequences; // bit i is set while ZX_FINDER_PATTERN_SEQUENCES[i] is still matched
+  int checksum;  // modulo 211
+  int characterCount;
+  int checkValue;
+} ZXRSSExpandedAssembly;
+
+static void ZXRSSExpandedRowSummarize(ZXRSSExpandedRow *row, ZXRSSExpandedRowSummary *summary) {
+  NSArray *pairs = row.pairs;
+  ZXRSSExpandedPair *firstPair = pairs[0];
+  summary->pairCount = (int)pairs.count;
+  summary->checksum = 0;
+  summary->characterCount = 0;
+  summary->checkPortion = firstPair.leftChar.checksumPortion;
+  summary->checkValue = firstPair.leftChar.value;
+  summary->hasFirstCharacter = firstPair.rightChar != nil;
+  for (int i = 0; i < summary->pairCount; i++) {
+    ZXRSSExpandedPair *pair = pairs[i];
+    if (i < ZX_FINDER_PATTERN_SEQUENCES_SUBLEN) {
+      summary->finderValues[i] = pair.finderPattern.value;
+    }
+    summary->checksum += pair.leftChar.checksumPortion;
+    summary->characterCount++;
+    if (pair.rightChar != nil) {
+      summary->checksum += pair.rightChar.checksumPortion;
+      summary->characterCount++;
+    }
+  }
+}
+
+// Appends the pairs of a row to an assembly; returns NO if they do not continue any finder pattern sequence
+static BOOL ZXRSSExpandedAppendRow(ZXRSSExpandedAssembly *assembly, const ZXRSSExpandedRowSummary *row, BOOL first) {
+  if (assembly->pairCount + row->pairCount > ZX_FINDER_PATTERN_SEQUENCES_SUBLEN) {
+    return NO;
+  }
+  int sequences = assembly->sequences;
+  for (int j = 0; j < row->pairCount; j++) {
+    int position = assembly->pairCount + j;
+    for (int i = 0; i < ZX_FINDER_PATTERN_SEQUENCES_LEN; i++) {
+      // Sequence i has i + 2 finder patterns
+      if (position >= i + 2 || ZX_FINDER_PATTERN_SEQUENCES[i][position] != row->finderValues[j]) {
+        sequences &= ~(1 << i);
+      }
+    }
+  }
+  if (sequences == 0) {
+    return NO;
+  }
+
+  assembly->pairCount += row->pairCount;
+  assembly->sequences = sequences;
+  if (first) {
+    assembly->checksum = (row->checksum - row->checkPortion) % 211;
+    assembly->characterCount = row->characterCount;
+    assembly->checkValue = row->checkValue;
+  } else {
+    assembly->checksum = (assembly->checksum + row->checksum) % 211;
+    assembly->characterCount += row->characterCount;
+  }
+  return YES;
+}
+
+static NSNumber *ZXRSSExpandedAssemblyKey(const ZXRSSExpandedAssembly *assembly, int nextRow) {
+  return @(((unsigned long long)nextRow << 48) |
+           ((unsigned long long)(assembly->checkValue & 0xFFFF) << 32) |
+           ((unsigned long long)assembly->sequences << 18) |
+           ((unsigned long long)assembly->checksum << 10) |
+           ((unsigned long long)assembly->characterCount << 4) |
+           (unsigned long long)assembly->pairCount);
+}
+
 @interface ZXRSSExpandedReader ()
 
 @property (nonatomic, strong, readonly) ZXIntArray *startEnd;
 @property (nonatomic, strong, readonly) NSMutableArray *pairs;
 @property (nonatomic, strong) NSMutableArray *rows;
 @property (nonatomic, assign) BOOL startFromEven;
+@property (nonatomic, assign) int storedRowCount;
+@property (nonatomic, assign) int evaluatedCombinationCount;
 
 @end
 
@@ -96,6 +186,8 @@ const int ZX_FINDER_PATTERN_SEQUENCES[ZX_FINDER_PATTERN_SEQUENCES_LEN][ZX_FINDER
     _rows = [NSMutableArray array];
     _startFromEven = NO;
     _startEnd = [[ZXIntArray alloc] initWithLength:2];
+    _maximumStoredRows = ZX_RSS_EXPANDED_MAX_STORED_ROWS;
+    _maximumRowCombinations = ZX_RSS_EXPANDED_MAX_ROW_COMBINATIONS;
   }
 
   return self;
@@ -168,19 +260,37 @@ const int ZX_FINDER_PATTERN_SEQUENCES[ZX_FINDER_PATTERN_SEQUENCES_LEN][ZX_FINDER
 
 - (NSMutableArray *)checkRows:(BOOL)reverse {
   // Limit number of rows we are checking
-  // We use recursive algorithm with pure complexity and don't want it to take forever
   // Stacked barcode can have up to 11 rows, so 25 seems resonable enough
-  if (self.rows.count > 25) {
+  if (self.rows.count > self.maximumStoredRows) {
     [self.rows removeAllObjects];
     return nil;
   }
 
-	[self.pairs removeAllObjects];
+  [self.pairs removeAllObjects];
   if (reverse) {
     self.rows = [[[self.rows reverseObjectEnumerator] allObjects] mutableCopy];
   }
 
-  NSMutableArray *ps = [self checkRows:[NSMutableArray array] current:0];
+  int count = (int)self.rows.count;
+  ZXRSSExpandedRowSummary *summaries = (ZXRSSExpandedRowSummary *)malloc(count * sizeof(ZXRSSExpandedRowSummary));
+  for (int i = 0; i < count; i++) {
+    ZXRSSExpandedRowSummarize(self.rows[i], &summaries[i]);
+  }
+
+  int collected[ZX_FINDER_PATTERN_SEQUENCES_SUBLEN];
+  int combinations = 0;
+  ZXRSSExpandedAssembly empty = { 0, ZX_RSS_EXPANDED_ALL_SEQUENCES, 0, 0, 0 };
+  int collectedCount = [self checkRows:summaries count:count assembly:empty current:0 collected:collected depth:0
+                                failed:[NSMutableSet set] combinations:&combinations];
+  free(summaries);
+
+  NSMutableArray *ps = nil;
+  if (collectedCount > 0) {
+    for (int i = 0; i < collectedCount; i++) {
+      [self.pairs addObjectsFromArray:[self.rows[collected[i]] pairs]];
+    }
+    ps = self.pairs;
+  }
 
   if (reverse) {
     self.rows = [[[self.rows reverseObjectEnumerator] allObjects] mutableCopy];
@@ -189,60 +299,50 @@ const int ZX_FINDER_PATTERN_SEQUENCES[ZX_FINDER_PATTERN_SEQUENCES_LEN][ZX_FINDER
   return ps;
 }
 
-// Try to construct a valid rows sequence
-// Recursion is used to implement backtracking
-- (NSMutableArray *)checkRows:(NSMutableArray *)collectedRows current:(int)currentRow {
-  for (int i = currentRow; i < [self.rows count]; i++) {
-    ZXRSSExpandedRow *row = self.rows[i];
-    [self.pairs removeAllObjects];
-    NSUInteger size = [collectedRows count];
-    for (int j = 0; j < size; j++) {
-      [self.pairs addObjectsFromArray:[collectedRows[j] pairs]];
-    }
-    [self.pairs addObjectsFromArray:row.pairs];
-
-    if (![self isValidSequence:self.pairs]) {
+// Try to construct a valid rows sequence, taking the rows in order and backtracking. The partial
+// assemblies that could not be completed are remembered in failed: any other combination reaching
+// the same state can be completed by exactly the same rows, so it is not searched again. This
+// bounds the search by the number of distinct states rather than the number of row subsets.
+// Returns the number of rows stored in collected, 0 if there is no valid sequence, or -1 if
+// maximumRowCombinations was reached.
+- (int)checkRows:(const ZXRSSExpandedRowSummary *)summaries count:(int)count assembly:(ZXRSSExpandedAssembly)assembly
+         current:(int)currentRow collected:(int *)collected depth:(int)depth failed:(NSMutableSet *)failed
+    combinations:(int *)combinations {
+  for (int i = currentRow; i < count; i++) {
+    if (self.maximumRowCombinations > 0 && *combinations >= self.maximumRowCombinations) {
+      return -1;
+    }
+    (*combinations)++;
+    self.evaluatedCombinationCount++;
+
+    const ZXRSSExpandedRowSummary *row = &summaries[i];
+    // Without a first character the checksum can never match
+    if (depth == 0 && !row->hasFirstCharacter) {
       continue;
     }
 
-    if ([self checkChecksum]) {
-      return self.pairs;
+    ZXRSSExpandedAssembly next = assembly;
+    if (!ZXRSSExpandedAppendRow(&next, row, depth == 0)) {
+      continue;
     }
 
-    NSMutableArray *rs = [NSMutableArray array];
-    [rs addObjectsFromArray:collectedRows];
-    [rs addObject:row];
-    NSMutableArray *ps = [self checkRows:rs current:i + 1];
-    if (ps) {
-      return ps;
+    collected[depth] = i;
+    if (211 * (next.characterCount - 4) + next.checksum == next.checkValue) {
+      return depth + 1;
     }
-  }
-  return nil;
-}
 
-// Whether the pairs form a valid find pattern seqience,
-// either complete or a prefix
-- (BOOL)isValidSequence:(NSArray *)pairs {
-  int count = (int)[pairs count];
-  for (int i = 0, sz = 2; i < ZX_FINDER_PATTERN_SEQUENCES_LEN; i++, sz++) {
-    if (count > sz) {
+    NSNumber *key = ZXRSSExpandedAssemblyKey(&next, i + 1);
+    if ([failed containsObject:key]) {
       continue;
     }
-
-    BOOL stop = YES;
-    for (int j = 0; j < count; j++) {
-      if ([[pairs[j] finderPattern] value] != ZX_FINDER_PATTERN_SEQUENCES[i][j]) {
-        stop = NO;
-        break;
-      }
-    }
-
-    if (stop) {
-      return YES;
+    int collectedCount = [self checkRows:summaries count:count assembly:next current:i + 1 collected:collected
+                                   depth:depth + 1 failed:failed combinations:combinations];
+    if (collectedCount != 0) {
+      return collectedCount;
     }
+    [failed addObject:key];
   }
-
-  return NO;
+  return 0;
 }
 
 - (void)storeRow:(int)rowNumber wasReversed:(BOOL)wasReversed {
@@ -273,6 +373,7 @@ const int ZX_FINDER_PATTERN_SEQUENCES[ZX_FINDER_PATTERN_SEQUENCES_LEN][ZX_FINDER
   }
 
   [self.rows insertObject:[[ZXRSSExpandedRow alloc] initWithPairs:self.pairs rowNumber:rowNumber wasReversed:wasReversed] atIndex:insertPos];
+  self.storedRowCount++;
 
   [self removePartialRows:self.pairs from:self.rows];
 }
@@ -463,9 +564,15 @@ const int ZX_FINDER_PATTERN_SEQUENCES[ZX_FINDER_PATTERN_SEQUENCES_LEN][ZX_FINDER
   int counterPosition = 0;
   int patternStart = rowOffset;
   int32_t *array = counters.array;
-  for (int x = rowOffset; x < width; x++) {
+  int runCount;
+  const int32_t *runStarts = [row runStartsWithCount:&runCount];
+  int x = rowOffset;
+  int run = x < width ? [row runIndexAt:x] : runCount;
+  while (x < width) {
     if ([row get:x] ^ isWhite) {
-      array[counterPosition]++;
+      // Count the rest of this run at once
+      array[counterPosition] += runStarts[run + 1] - x;
+      x = runStarts[++run];
     } else {
       if (counterPosition == 3) {
         if (searchingEvenPair) {
@@ -491,7 +598,7 @@ const int ZX_FINDER_PATTERN_SEQUENCES[ZX_FINDER_PATTERN_SEQUENCES_LEN][ZX_FINDER
       } else {
         counterPosition++;
       }
-      array[counterPosition] = 1;
+      array[counterPosition] = 0;
       isWhite = !isWhite;
     }
   }
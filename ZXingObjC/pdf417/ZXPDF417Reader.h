@@ -21,6 +21,8 @@
 
 /**
  * This implementation can detect and decode PDF417 codes in an image.
+ * It keeps no state between decodes and may be used from several threads at once, as long as
+ * each thread decodes its own ZXBinaryBitmap.
  */
 @interface ZXPDF417Reader : NSObject <ZXReader, ZXMultipleBarcodeReader>
 
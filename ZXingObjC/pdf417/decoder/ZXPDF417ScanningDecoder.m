@@ -454,25 +454,28 @@ static ZXPDF417ECErrorCorrection *errorCorrection;
                        startColumn:(int)startColumn
                           imageRow:(int)imageRow {
   int imageColumn = startColumn;
-  NSMutableArray *moduleBitCount = [NSMutableArray arrayWithCapacity:8];
-  for (int i = 0; i < 8; i++) {
-    [moduleBitCount addObject:@0];
-  }
+  int counts[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+  int moduleCount = 8;
   int moduleNumber = 0;
   int increment = leftToRight ? 1 : -1;
   BOOL previousPixelValue = leftToRight;
   while (((leftToRight && imageColumn < maxColumn) || (!leftToRight && imageColumn >= minColumn)) &&
-      moduleNumber < [moduleBitCount count]) {
-    if ([image getX:imageColumn y:imageRow] == previousPixelValue) {
-      moduleBitCount[moduleNumber] = @([moduleBitCount[moduleNumber] intValue] + 1);
-      imageColumn += increment;
-    } else {
+      moduleNumber < moduleCount) {
+    int remaining = leftToRight ? maxColumn - imageColumn : imageColumn - minColumn + 1;
+    int run = [image runLengthFromX:imageColumn y:imageRow dx:increment dy:0 value:previousPixelValue maxCount:remaining];
+    counts[moduleNumber] += run;
+    imageColumn += run * increment;
+    if (run < remaining) {
       moduleNumber++;
       previousPixelValue = !previousPixelValue;
     }
   }
-  if (moduleNumber == [moduleBitCount count] ||
-      (((leftToRight && imageColumn == maxColumn) || (!leftToRight && imageColumn == minColumn)) && moduleNumber == [moduleBitCount count] - 1)) {
+  if (moduleNumber == moduleCount ||
+      (((leftToRight && imageColumn == maxColumn) || (!leftToRight && imageColumn == minColumn)) && moduleNumber == moduleCount - 1)) {
+    NSMutableArray *moduleBitCount = [NSMutableArray arrayWithCapacity:moduleCount];
+    for (int i = 0; i < moduleCount; i++) {
+      [moduleBitCount addObject:@(counts[i])];
+    }
     return moduleBitCount;
   }
   return nil;
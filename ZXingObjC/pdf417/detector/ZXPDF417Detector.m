@@ -17,6 +17,7 @@
 #import "ZXBitArray.h"
 #import "ZXBitMatrix.h"
 #import "ZXBinaryBitmap.h"
+#import "ZXCancellationToken.h"
 #import "ZXDecodeHints.h"
 #import "ZXErrors.h"
 #import "ZXGridSampler.h"
@@ -63,6 +64,10 @@ const int ZX_PDF417_BARCODE_MIN_HEIGHT = 10;
     return nil;
   }
   if ([barcodeCoordinates count] == 0) {
+    if (hints.cancellationToken.isCancelled) {
+      if (error) *error = ZXNotFoundErrorInstance();
+      return nil;
+    }
     bitMatrix = [bitMatrix copy];
     [bitMatrix rotate180];
     barcodeCoordinates = [self detect:multiple bitMatrix:bitMatrix error:error];
@@ -276,28 +281,32 @@ const int ZX_PDF417_BARCODE_MIN_HEIGHT = 10;
   }
   int x = patternStart;
   int counterPosition = 0;
-  for (;x < width; x++) {
-    BOOL pixel = [matrix getX:x y:row];
-    if (pixel ^ isWhite) {
-      counters[counterPosition] = counters[counterPosition] + 1;
-    } else {
-      if (counterPosition == patternLength - 1) {
-        if ([self patternMatchVariance:counters countersSize:patternLength pattern:pattern maxIndividualVariance:ZX_PDF417_MAX_INDIVIDUAL_VARIANCE] < ZX_PDF417_MAX_AVG_VARIANCE) {
-          return NSMakeRange(patternStart, x - patternStart);
-        }
-        patternStart += counters[0] + counters[1];
-        for (int y = 2; y < patternLength; y++) {
-          counters[y - 2] = counters[y];
-        }
-        counters[patternLength - 2] = 0;
-        counters[patternLength - 1] = 0;
-        counterPosition--;
-      } else {
-        counterPosition++;
+  while (x < width) {
+    // Count the rest of the current run a word at a time
+    int run = [matrix runLengthFromX:x y:row dx:1 dy:0 value:!isWhite maxCount:width - x];
+    counters[counterPosition] += run;
+    x += run;
+    if (x == width) {
+      break;
+    }
+
+    if (counterPosition == patternLength - 1) {
+      if ([self patternMatchVariance:counters countersSize:patternLength pattern:pattern maxIndividualVariance:ZX_PDF417_MAX_INDIVIDUAL_VARIANCE] < ZX_PDF417_MAX_AVG_VARIANCE) {
+        return NSMakeRange(patternStart, x - patternStart);
       }
-      counters[counterPosition] = 1;
-      isWhite = !isWhite;
+      patternStart += counters[0] + counters[1];
+      for (int y = 2; y < patternLength; y++) {
+        counters[y - 2] = counters[y];
+      }
+      counters[patternLength - 2] = 0;
+      counters[patternLength - 1] = 0;
+      counterPosition--;
+    } else {
+      counterPosition++;
     }
+    counters[counterPosition] = 1;
+    isWhite = !isWhite;
+    x++;
   }
   if (counterPosition == patternLength - 1) {
     if ([self patternMatchVariance:counters countersSize:patternLen pattern:pattern maxIndividualVariance:ZX_PDF417_MAX_INDIVIDUAL_VARIANCE] < ZX_PDF417_MAX_AVG_VARIANCE) {
@@ -20,6 +20,8 @@
 
 /**
  * This implementation can detect and decode QR Codes in an image.
+ * It keeps no state between decodes and may be used from several threads at once, as long as
+ * each thread decodes its own ZXBinaryBitmap.
  */
 @interface ZXQRCodeReader : NSObject <ZXReader>
 
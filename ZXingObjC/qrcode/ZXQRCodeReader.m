@@ -53,6 +53,7 @@
 - (ZXResult *)decode:(ZXBinaryBitmap *)image hints:(ZXDecodeHints *)hints error:(NSError **)error {
   ZXDecoderResult *decoderResult;
   NSMutableArray *points;
+  ZXQRCodeDetector *detector = nil;
   ZXBitMatrix *matrix = [image blackMatrixWithError:error];
   if (!matrix) {
     return nil;
@@ -69,7 +70,8 @@
     }
     points = [NSMutableArray array];
   } else {
-    ZXDetectorResult *detectorResult = [[[ZXQRCodeDetector alloc] initWithImage:matrix] detect:hints error:error];
+    detector = [[ZXQRCodeDetector alloc] initWithImage:matrix];
+    ZXDetectorResult *detectorResult = [detector detect:hints error:error];
     if (!detectorResult) {
       return nil;
     }
@@ -103,6 +105,10 @@
     [result putMetadata:kResultMetadataTypeStructuredAppendParity
                   value:@(decoderResult.structuredAppendParity)];
   }
+  if (detector) {
+    [result putMetadata:kResultMetadataTypeDetectionCandidateCount value:@(detector.candidateUpdateCount)];
+    [result putMetadata:kResultMetadataTypeDetectionResultPointCount value:@(detector.resultPointAllocationCount)];
+  }
   return result;
 }
 
@@ -176,7 +176,8 @@ static NSArray *DATA_MASKS = nil;
 
 
 + (ZXQRCodeDataMask *)forReference:(int)reference {
-  if (!DATA_MASKS) {
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
     DATA_MASKS = @[[[ZXDataMask000 alloc] init],
                    [[ZXDataMask001 alloc] init],
                    [[ZXDataMask010 alloc] init],
@@ -185,7 +186,7 @@ static NSArray *DATA_MASKS = nil;
                    [[ZXDataMask101 alloc] init],
                    [[ZXDataMask110 alloc] init],
                    [[ZXDataMask111 alloc] init]];
-  }
+  });
 
   if (reference < 0 || reference > 7) {
     [NSException raise:NSInvalidArgumentException format:@"Invalid reference value"];
@@ -35,10 +35,11 @@ static NSArray *FOR_BITS = nil;
 }
 
 + (ZXQRCodeErrorCorrectionLevel *)forBits:(int)bits {
-  if (!FOR_BITS) {
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
     FOR_BITS = @[[ZXQRCodeErrorCorrectionLevel errorCorrectionLevelM], [ZXQRCodeErrorCorrectionLevel errorCorrectionLevelL],
                  [ZXQRCodeErrorCorrectionLevel errorCorrectionLevelH], [ZXQRCodeErrorCorrectionLevel errorCorrectionLevelQ]];
-  }
+  });
 
   if (bits < 0 || bits >= [FOR_BITS count]) {
     @throw [NSException exceptionWithName:NSInvalidArgumentException
@@ -57,22 +57,20 @@
   int maxJ = self.startX + self.width;
   int middleI = self.startY + (self.height >> 1);
   int stateCount[3];
+  int32_t *bits = self.image.bits;
+  int rowSize = self.image.rowSize;
 
   for (int iGen = 0; iGen < self.height; iGen++) {
     int i = middleI + ((iGen & 0x01) == 0 ? (iGen + 1) >> 1 : -((iGen + 1) >> 1));
     stateCount[0] = 0;
     stateCount[1] = 0;
     stateCount[2] = 0;
-    int j = self.startX;
-
-    while (j < maxJ && ![self.image getX:j y:i]) {
-      j++;
-    }
+    int j = self.startX + [self.image runLengthFromX:self.startX y:i dx:1 dy:0 value:NO maxCount:maxJ - self.startX];
 
     int currentState = 0;
 
     while (j < maxJ) {
-      if ([self.image getX:j y:i]) {
+      if (ZXBitMatrixGetBit(bits, rowSize, j, i)) {
         if (currentState == 1) {
           stateCount[currentState]++;
         } else {
@@ -156,40 +154,28 @@
   [self.crossCheckStateCount clear];
   int32_t *stateCount = self.crossCheckStateCount.array;
 
-  int i = startI;
-  while (i >= 0 && [self.image getX:centerJ y:i] && stateCount[1] <= maxCount) {
-    stateCount[1]++;
-    i--;
-  }
-
+  // Start counting up from center
+  stateCount[1] = [self.image runLengthFromX:centerJ y:startI dx:0 dy:-1 value:YES maxCount:maxCount + 1];
+  int i = startI - stateCount[1];
   if (i < 0 || stateCount[1] > maxCount) {
     return NAN;
   }
 
-  while (i >= 0 && ![self.image getX:centerJ y:i] && stateCount[0] <= maxCount) {
-    stateCount[0]++;
-    i--;
-  }
-
+  stateCount[0] = [self.image runLengthFromX:centerJ y:i dx:0 dy:-1 value:NO maxCount:maxCount + 1];
   if (stateCount[0] > maxCount) {
     return NAN;
   }
-  i = startI + 1;
-
-  while (i < maxI && [self.image getX:centerJ y:i] && stateCount[1] <= maxCount) {
-    stateCount[1]++;
-    i++;
-  }
 
+  // Now also count down from center
+  int down = [self.image runLengthFromX:centerJ y:startI + 1 dx:0 dy:1 value:YES maxCount:maxCount + 1 - stateCount[1]];
+  stateCount[1] += down;
+  i = startI + 1 + down;
   if (i == maxI || stateCount[1] > maxCount) {
     return NAN;
   }
 
-  while (i < maxI && ![self.image getX:centerJ y:i] && stateCount[2] <= maxCount) {
-    stateCount[2]++;
-    i++;
-  }
-
+  stateCount[2] = [self.image runLengthFromX:centerJ y:i dx:0 dy:1 value:NO maxCount:maxCount + 1];
+  i += stateCount[2];
   if (stateCount[2] > maxCount) {
     return NAN;
   }
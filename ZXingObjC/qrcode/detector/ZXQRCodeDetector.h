@@ -26,6 +26,17 @@
 @property (nonatomic, strong, readonly) ZXBitMatrix *image;
 @property (nonatomic, weak, readonly) id <ZXResultPointCallback> resultPointCallback;
 
+/**
+ * @return The candidateUpdateCount of the finder pattern finder used by the last detect, see
+ *         ZXQRCodeFinderPatternFinder.
+ */
+@property (nonatomic, assign, readonly) int candidateUpdateCount;
+
+/**
+ * @return The resultPointAllocationCount of the finder pattern finder used by the last detect.
+ */
+@property (nonatomic, assign, readonly) int resultPointAllocationCount;
+
 - (id)initWithImage:(ZXBitMatrix *)image;
 
 /**
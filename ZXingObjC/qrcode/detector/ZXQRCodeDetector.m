@@ -35,6 +35,8 @@
 @interface ZXQRCodeDetector ()
 
 @property (nonatomic, weak) id<ZXResultPointCallback> resultPointCallback;
+@property (nonatomic, assign) int candidateUpdateCount;
+@property (nonatomic, assign) int resultPointAllocationCount;
 
 @end
 
@@ -57,6 +59,8 @@
 
   ZXQRCodeFinderPatternFinder *finder = [[ZXQRCodeFinderPatternFinder alloc] initWithImage:self.image resultPointCallback:self.resultPointCallback];
   ZXQRCodeFinderPatternInfo *info = [finder find:hints error:error];
+  self.candidateUpdateCount = finder.candidateUpdateCount;
+  self.resultPointAllocationCount = finder.resultPointAllocationCount;
   if (!info) {
     return nil;
   }
@@ -267,6 +271,8 @@
 
   // In black pixels, looking for white, first or second time.
   int state = 0;
+  int32_t *bits = self.image.bits;
+  int rowSize = self.image.rowSize;
   // Loop up until x == toX, but not beyond
   int xLimit = toX + xstep;
   for (int x = fromX, y = fromY; x != xLimit; x += xstep) {
@@ -276,7 +282,7 @@
     // Does current pixel mean we have moved white to black or vice versa?
     // Scanning black in state 0,2 and white in state 1, so if we find the wrong
     // color, advance to next state or end if we are in state 2 already
-    if ((state == 1) == [self.image getX:realX y:realY]) {
+    if ((state == 1) == ZXBitMatrixGetBit(bits, rowSize, realX, realY)) {
       if (state == 2) {
         return [ZXMathUtils distanceInt:x aY:y bX:fromX bY:fromY];
       }
@@ -29,8 +29,25 @@ extern const int ZX_FINDER_PATTERN_MAX_MODULES;
 @interface ZXQRCodeFinderPatternFinder : NSObject
 
 @property (nonatomic, strong, readonly) ZXBitMatrix *image;
+
+/**
+ * Candidates are tracked in a plain C array while scanning; this returns a new array of
+ * ZXQRCodeFinderPattern objects built from them, so changes to it are not seen by the finder.
+ */
 @property (nonatomic, strong, readonly) NSMutableArray *possibleCenters;
 
+/**
+ * @return The number of times this finder added a candidate or combined another estimate into
+ *         one. Keeping candidates as objects would take one allocation for each of these.
+ */
+@property (nonatomic, assign, readonly) int candidateUpdateCount;
+
+/**
+ * @return The number of ZXResultPoint objects this finder created, normally just the three
+ *         patterns returned plus one per new candidate when a result point callback is set.
+ */
+@property (nonatomic, assign, readonly) int resultPointAllocationCount;
+
 /**
  * Creates a finder that will search the image for three finder patterns.
  *
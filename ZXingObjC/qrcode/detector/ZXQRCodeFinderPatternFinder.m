@@ -15,6 +15,7 @@
  */
 
 #import "ZXBitMatrix.h"
+#import "ZXCancellationToken.h"
 #import "ZXDecodeHints.h"
 #import "ZXErrors.h"
 #import "ZXQRCodeFinderPattern.h"
@@ -29,14 +30,25 @@ const int ZX_FINDER_PATTERN_MAX_MODULES = 57;
 
 const int ZX_QR_CODE_INTEGER_MATH_SHIFT = 8;
 
-@interface ZXQRCodeFinderPatternFinder ()
+/**
+ * A possible finder pattern center, the struct counterpart of ZXQRCodeFinderPattern.
+ */
+typedef struct {
+  float x;
+  float y;
+  float estimatedModuleSize;
+  int count;
+} ZXQRCodeFinderCandidate;
 
-NSInteger centerCompare(id center1, id center2, void *context);
-NSInteger furthestFromAverageCompare(id center1, id center2, void *context);
+typedef int (*ZXQRCodeFinderCandidateCompare)(const ZXQRCodeFinderCandidate *, const ZXQRCodeFinderCandidate *, float);
+
+@interface ZXQRCodeFinderPatternFinder ()
 
 @property (nonatomic, assign) BOOL hasSkipped;
 @property (nonatomic, weak, readonly) id<ZXResultPointCallback> resultPointCallback;
-@property (nonatomic, strong) NSMutableArray *possibleCenters;
+@property (nonatomic, assign) ZXQRCodeFinderCandidate *candidates;
+@property (nonatomic, assign) int candidateCount;
+@property (nonatomic, assign) int candidateCapacity;
 
 @end
 
@@ -49,13 +61,35 @@ NSInteger furthestFromAverageCompare(id center1, id center2, void *context);
 - (id)initWithImage:(ZXBitMatrix *)image resultPointCallback:(id<ZXResultPointCallback>)resultPointCallback {
   if (self = [super init]) {
     _image = image;
-    _possibleCenters = [NSMutableArray array];
     _resultPointCallback = resultPointCallback;
   }
 
   return self;
 }
 
+- (void)dealloc {
+  if (_candidates != NULL) {
+    free(_candidates);
+    _candidates = NULL;
+  }
+}
+
+- (NSMutableArray *)possibleCenters {
+  NSMutableArray *possibleCenters = [NSMutableArray arrayWithCapacity:self.candidateCount];
+  for (int i = 0; i < self.candidateCount; i++) {
+    [possibleCenters addObject:[self patternForCandidate:&_candidates[i]]];
+  }
+  return possibleCenters;
+}
+
+- (ZXQRCodeFinderPattern *)patternForCandidate:(const ZXQRCodeFinderCandidate *)candidate {
+  _resultPointAllocationCount++;
+  return [[ZXQRCodeFinderPattern alloc] initWithPosX:candidate->x
+                                                posY:candidate->y
+                                 estimatedModuleSize:candidate->estimatedModuleSize
+                                               count:candidate->count];
+}
+
 - (ZXQRCodeFinderPatternInfo *)find:(ZXDecodeHints *)hints error:(NSError **)error {
   BOOL tryHarder = hints != nil && hints.tryHarder;
   BOOL pureBarcode = hints != nil && hints.pureBarcode;
@@ -66,9 +100,17 @@ NSInteger furthestFromAverageCompare(id center1, id center2, void *context);
     iSkip = ZX_FINDER_PATTERN_MIN_SKIP;
   }
 
+  int32_t *bits = self.image.bits;
+  int rowSize = self.image.rowSize;
   BOOL done = NO;
   int stateCount[5];
+  ZXCancellationToken *cancellationToken = hints.cancellationToken;
   for (int i = iSkip - 1; i < maxI && !done; i += iSkip) {
+    if (cancellationToken.isCancelled) {
+      if (error) *error = ZXNotFoundErrorInstance();
+      return nil;
+    }
+
     stateCount[0] = 0;
     stateCount[1] = 0;
     stateCount[2] = 0;
@@ -77,7 +119,7 @@ NSInteger furthestFromAverageCompare(id center1, id center2, void *context);
     int currentState = 0;
 
     for (int j = 0; j < maxJ; j++) {
-      if ([self.image getX:j y:i]) {
+      if (ZXBitMatrixGetBit(bits, rowSize, j, i)) {
         if ((currentState & 1) == 1) {
           currentState++;
         }
@@ -199,21 +241,16 @@ NSInteger furthestFromAverageCompare(id center1, id center2, void *context);
   int stateCount[5] = {0, 0, 0, 0, 0};
 
   // Start counting up, left from center finding black center mass
-  int i = 0;
-  while (startI - i >= 0 && [self.image getX:centerJ - i y:startI - i]) {
-    stateCount[2]++;
-    i++;
-  }
+  stateCount[2] = [self.image runLengthFromX:centerJ y:startI dx:-1 dy:-1 value:YES maxCount:INT_MAX];
+  int i = stateCount[2];
 
   if ((startI - i < 0) || (centerJ - i < 0)) {
     return NO;
   }
 
   // Continue up, left finding white space
-  while ((startI - i >= 0) && (centerJ - i >= 0) && ![self.image getX:centerJ - i y:startI - i] && stateCount[1] <= maxCount) {
-    stateCount[1]++;
-    i++;
-  }
+  stateCount[1] = [self.image runLengthFromX:centerJ - i y:startI - i dx:-1 dy:-1 value:NO maxCount:maxCount + 1];
+  i += stateCount[1];
 
   // If already too many modules in this state or ran off the edge:
   if ((startI - i < 0) || (centerJ - i < 0) || stateCount[1] > maxCount) {
@@ -221,40 +258,28 @@ NSInteger furthestFromAverageCompare(id center1, id center2, void *context);
   }
 
   // Continue up, left finding black border
-  while ((startI - i >= 0) && (centerJ - i >= 0) && [self.image getX:centerJ - i y:startI - i] && stateCount[0] <= maxCount) {
-    stateCount[0]++;
-    i++;
-  }
+  stateCount[0] = [self.image runLengthFromX:centerJ - i y:startI - i dx:-1 dy:-1 value:YES maxCount:maxCount + 1];
   if (stateCount[0] > maxCount) {
     return NO;
   }
 
   // Now also count down, right from center
-  i = 1;
-  while ((startI + i < maxI) && (centerJ + i < maxJ) && [self.image getX:centerJ + i y:startI + i]) {
-    stateCount[2]++;
-    i++;
-  }
+  i = 1 + [self.image runLengthFromX:centerJ + 1 y:startI + 1 dx:1 dy:1 value:YES maxCount:INT_MAX];
+  stateCount[2] += i - 1;
 
   // Ran off the edge?
   if ((startI + i >= maxI) || (centerJ + i >= maxJ)) {
     return NO;
   }
 
-  while ((startI + i < maxI) && (centerJ + i < maxJ) && ![self.image getX:centerJ + i y:startI + i] && stateCount[3] < maxCount) {
-    stateCount[3]++;
-    i++;
-  }
+  stateCount[3] = [self.image runLengthFromX:centerJ + i y:startI + i dx:1 dy:1 value:NO maxCount:maxCount];
+  i += stateCount[3];
 
   if ((startI + i >= maxI) || (centerJ + i >= maxJ) || stateCount[3] >= maxCount) {
     return NO;
   }
 
-  while ((startI + i < maxI) && (centerJ + i < maxJ) && [self.image getX:centerJ + i y:startI + i] && stateCount[4] < maxCount) {
-    stateCount[4]++;
-    i++;
-  }
-
+  stateCount[4] = [self.image runLengthFromX:centerJ + i y:startI + i dx:1 dy:1 value:YES maxCount:maxCount];
   if (stateCount[4] >= maxCount) {
     return NO;
   }
@@ -281,49 +306,39 @@ NSInteger furthestFromAverageCompare(id center1, id center2, void *context);
 - (float)crossCheckVertical:(int)startI centerJ:(int)centerJ maxCount:(int)maxCount originalStateCountTotal:(int)originalStateCountTotal {
   int maxI = self.image.height;
   int stateCount[5] = {0, 0, 0, 0, 0};
+  // Column centerJ of the image is row centerJ of its transpose, which is scanned a word at a time
+  ZXBitMatrix *columns = [self.image transposedMatrix];
 
-  int i = startI;
-  while (i >= 0 && [self.image getX:centerJ y:i]) {
-    stateCount[2]++;
-    i--;
-  }
+  // Start counting up from center
+  stateCount[2] = [columns runLengthFromX:startI y:centerJ dx:-1 dy:0 value:YES maxCount:INT_MAX];
+  int i = startI - stateCount[2];
   if (i < 0) {
     return NAN;
   }
-  while (i >= 0 && ![self.image getX:centerJ y:i] && stateCount[1] <= maxCount) {
-    stateCount[1]++;
-    i--;
-  }
+  stateCount[1] = [columns runLengthFromX:i y:centerJ dx:-1 dy:0 value:NO maxCount:maxCount + 1];
+  i -= stateCount[1];
   if (i < 0 || stateCount[1] > maxCount) {
     return NAN;
   }
-  while (i >= 0 && [self.image getX:centerJ y:i] && stateCount[0] <= maxCount) {
-    stateCount[0]++;
-    i--;
-  }
+  stateCount[0] = [columns runLengthFromX:i y:centerJ dx:-1 dy:0 value:YES maxCount:maxCount + 1];
   if (stateCount[0] > maxCount) {
     return NAN;
   }
 
-  i = startI + 1;
-  while (i < maxI && [self.image getX:centerJ y:i]) {
-    stateCount[2]++;
-    i++;
-  }
+  // Now also count down from center
+  int down = [columns runLengthFromX:startI + 1 y:centerJ dx:1 dy:0 value:YES maxCount:INT_MAX];
+  stateCount[2] += down;
+  i = startI + 1 + down;
   if (i == maxI) {
     return NAN;
   }
-  while (i < maxI && ![self.image getX:centerJ y:i] && stateCount[3] < maxCount) {
-    stateCount[3]++;
-    i++;
-  }
+  stateCount[3] = [columns runLengthFromX:i y:centerJ dx:1 dy:0 value:NO maxCount:maxCount];
+  i += stateCount[3];
   if (i == maxI || stateCount[3] >= maxCount) {
     return NAN;
   }
-  while (i < maxI && [self.image getX:centerJ y:i] && stateCount[4] < maxCount) {
-    stateCount[4]++;
-    i++;
-  }
+  stateCount[4] = [columns runLengthFromX:i y:centerJ dx:1 dy:0 value:YES maxCount:maxCount];
+  i += stateCount[4];
   if (stateCount[4] >= maxCount) {
     return NAN;
   }
@@ -344,48 +359,34 @@ NSInteger furthestFromAverageCompare(id center1, id center2, void *context);
   int maxJ = self.image.width;
   int stateCount[5] = {0, 0, 0, 0, 0};
 
-  int j = startJ;
-  while (j >= 0 && [self.image getX:j y:centerI]) {
-    stateCount[2]++;
-    j--;
-  }
+  stateCount[2] = [self.image runLengthFromX:startJ y:centerI dx:-1 dy:0 value:YES maxCount:INT_MAX];
+  int j = startJ - stateCount[2];
   if (j < 0) {
     return NAN;
   }
-  while (j >= 0 && ![self.image getX:j y:centerI] && stateCount[1] <= maxCount) {
-    stateCount[1]++;
-    j--;
-  }
+  stateCount[1] = [self.image runLengthFromX:j y:centerI dx:-1 dy:0 value:NO maxCount:maxCount + 1];
+  j -= stateCount[1];
   if (j < 0 || stateCount[1] > maxCount) {
     return NAN;
   }
-  while (j >= 0 && [self.image getX:j y:centerI] && stateCount[0] <= maxCount) {
-    stateCount[0]++;
-    j--;
-  }
+  stateCount[0] = [self.image runLengthFromX:j y:centerI dx:-1 dy:0 value:YES maxCount:maxCount + 1];
   if (stateCount[0] > maxCount) {
     return NAN;
   }
 
-  j = startJ + 1;
-  while (j < maxJ && [self.image getX:j y:centerI]) {
-    stateCount[2]++;
-    j++;
-  }
+  int right = [self.image runLengthFromX:startJ + 1 y:centerI dx:1 dy:0 value:YES maxCount:INT_MAX];
+  stateCount[2] += right;
+  j = startJ + 1 + right;
   if (j == maxJ) {
     return NAN;
   }
-  while (j < maxJ && ![self.image getX:j y:centerI] && stateCount[3] < maxCount) {
-    stateCount[3]++;
-    j++;
-  }
+  stateCount[3] = [self.image runLengthFromX:j y:centerI dx:1 dy:0 value:NO maxCount:maxCount];
+  j += stateCount[3];
   if (j == maxJ || stateCount[3] >= maxCount) {
     return NAN;
   }
-  while (j < maxJ && [self.image getX:j y:centerI] && stateCount[4] < maxCount) {
-    stateCount[4]++;
-    j++;
-  }
+  stateCount[4] = [self.image runLengthFromX:j y:centerI dx:1 dy:0 value:YES maxCount:maxCount];
+  j += stateCount[4];
   if (stateCount[4] >= maxCount) {
     return NAN;
   }
@@ -407,23 +408,36 @@ NSInteger furthestFromAverageCompare(id center1, id center2, void *context);
     if (!isnan(centerJ) &&
         (!pureBarcode || [self crossCheckDiagonal:(int)centerI centerJ:(int) centerJ maxCount:stateCount[2] originalStateCountTotal:stateCountTotal])) {
       float estimatedModuleSize = (float)stateCountTotal / 7.0f;
-      BOOL found = NO;
-      int max = (int)[self.possibleCenters count];
+      _candidateUpdateCount++;
+      ZXQRCodeFinderCandidate *candidates = self.candidates;
+      int max = self.candidateCount;
       for (int index = 0; index < max; index++) {
-        ZXQRCodeFinderPattern *center = self.possibleCenters[index];
-        if ([center aboutEquals:estimatedModuleSize i:centerI j:centerJ]) {
-          self.possibleCenters[index] = [center combineEstimateI:centerI j:centerJ newModuleSize:estimatedModuleSize];
-          found = YES;
-          break;
+        ZXQRCodeFinderCandidate *center = &candidates[index];
+        // Same as ZXQRCodeFinderPattern aboutEquals:i:j: and combineEstimateI:j:newModuleSize:
+        if (fabsf(centerI - center->y) <= estimatedModuleSize && fabsf(centerJ - center->x) <= estimatedModuleSize) {
+          float moduleSizeDiff = fabsf(estimatedModuleSize - center->estimatedModuleSize);
+          if (moduleSizeDiff <= 1.0f || moduleSizeDiff <= center->estimatedModuleSize) {
+            int combinedCount = center->count + 1;
+            center->x = (center->count * center->x + centerJ) / combinedCount;
+            center->y = (center->count * center->y + centerI) / combinedCount;
+            center->estimatedModuleSize = (center->count * center->estimatedModuleSize + estimatedModuleSize) / combinedCount;
+            center->count = combinedCount;
+            return YES;
+          }
         }
       }
 
-      if (!found) {
-        ZXResultPoint *point = [[ZXQRCodeFinderPattern alloc] initWithPosX:centerJ posY:centerI estimatedModuleSize:estimatedModuleSize];
-        [self.possibleCenters addObject:point];
-        if (self.resultPointCallback != nil) {
-          [self.resultPointCallback foundPossibleResultPoint:point];
-        }
+      if (self.candidateCount == self.candidateCapacity) {
+        self.candidateCapacity = self.candidateCapacity == 0 ? 8 : 2 * self.candidateCapacity;
+        self.candidates = (ZXQRCodeFinderCandidate *)realloc(self.candidates, self.candidateCapacity * sizeof(ZXQRCodeFinderCandidate));
+      }
+      ZXQRCodeFinderCandidate *candidate = &self.candidates[self.candidateCount++];
+      candidate->x = centerJ;
+      candidate->y = centerI;
+      candidate->estimatedModuleSize = estimatedModuleSize;
+      candidate->count = 1;
+      if (self.resultPointCallback != nil) {
+        [self.resultPointCallback foundPossibleResultPoint:[self patternForCandidate:candidate]];
       }
       return YES;
     }
@@ -438,19 +452,19 @@ NSInteger furthestFromAverageCompare(id center1, id center2, void *context);
  *         down in the image.
  */
 - (int)findRowSkip {
-  int max = (int)[self.possibleCenters count];
+  int max = self.candidateCount;
   if (max <= 1) {
     return 0;
   }
-  ZXResultPoint *firstConfirmedCenter = nil;
+  const ZXQRCodeFinderCandidate *firstConfirmedCenter = NULL;
   for (int i = 0; i < max; i++) {
-    ZXQRCodeFinderPattern *center = self.possibleCenters[i];
-    if ([center count] >= ZX_CENTER_QUORUM) {
-      if (firstConfirmedCenter == nil) {
+    const ZXQRCodeFinderCandidate *center = &self.candidates[i];
+    if (center->count >= ZX_CENTER_QUORUM) {
+      if (firstConfirmedCenter == NULL) {
         firstConfirmedCenter = center;
       } else {
         self.hasSkipped = YES;
-        return (int)(fabsf([firstConfirmedCenter x] - [center x]) - fabsf([firstConfirmedCenter y] - [center y])) / 2;
+        return (int)(fabsf(firstConfirmedCenter->x - center->x) - fabsf(firstConfirmedCenter->y - center->y)) / 2;
       }
     }
   }
@@ -465,12 +479,12 @@ NSInteger furthestFromAverageCompare(id center1, id center2, void *context);
 - (BOOL)haveMultiplyConfirmedCenters {
   int confirmedCount = 0;
   float totalModuleSize = 0.0f;
-  int max = (int)[self.possibleCenters count];
+  const ZXQRCodeFinderCandidate *candidates = self.candidates;
+  int max = self.candidateCount;
   for (int i = 0; i < max; i++) {
-    ZXQRCodeFinderPattern *pattern = self.possibleCenters[i];
-    if ([pattern count] >= ZX_CENTER_QUORUM) {
+    if (candidates[i].count >= ZX_CENTER_QUORUM) {
       confirmedCount++;
-      totalModuleSize += [pattern estimatedModuleSize];
+      totalModuleSize += candidates[i].estimatedModuleSize;
     }
   }
   if (confirmedCount < 3) {
@@ -480,8 +494,7 @@ NSInteger furthestFromAverageCompare(id center1, id center2, void *context);
   float average = totalModuleSize / (float)max;
   float totalDeviation = 0.0f;
   for (int i = 0; i < max; i++) {
-    ZXQRCodeFinderPattern *pattern = self.possibleCenters[i];
-    totalDeviation += fabsf([pattern estimatedModuleSize] - average);
+    totalDeviation += fabsf(candidates[i].estimatedModuleSize - average);
   }
   return totalDeviation <= 0.05f * totalModuleSize;
 }
@@ -489,29 +502,40 @@ NSInteger furthestFromAverageCompare(id center1, id center2, void *context);
 /**
  * Orders by ZXFinderPattern count, descending.
  */
-NSInteger centerCompare(id center1, id center2, void *context) {
-  float average = [(__bridge NSNumber *)context floatValue];
-
-  if ([((ZXQRCodeFinderPattern *)center2) count] == [((ZXQRCodeFinderPattern *)center1) count]) {
-    float dA = fabsf([((ZXQRCodeFinderPattern *)center2) estimatedModuleSize] - average);
-    float dB = fabsf([((ZXQRCodeFinderPattern *)center1) estimatedModuleSize] - average);
+static int ZXQRCodeCenterCompare(const ZXQRCodeFinderCandidate *center1, const ZXQRCodeFinderCandidate *center2, float average) {
+  if (center2->count == center1->count) {
+    float dA = fabsf(center2->estimatedModuleSize - average);
+    float dB = fabsf(center1->estimatedModuleSize - average);
     return dA < dB ? 1 : dA == dB ? 0 : -1;
   } else {
-    return [((ZXQRCodeFinderPattern *)center2) count] - [((ZXQRCodeFinderPattern *)center1) count];
+    return center2->count - center1->count;
   }
 }
 
 /**
  * Orders by furthest from average
  */
-NSInteger furthestFromAverageCompare(id center1, id center2, void *context) {
-  float average = [(__bridge NSNumber *)context floatValue];
-
-  float dA = fabsf([((ZXQRCodeFinderPattern *)center2) estimatedModuleSize] - average);
-  float dB = fabsf([((ZXQRCodeFinderPattern *)center1) estimatedModuleSize] - average);
+static int ZXQRCodeFurthestFromAverageCompare(const ZXQRCodeFinderCandidate *center1, const ZXQRCodeFinderCandidate *center2, float average) {
+  float dA = fabsf(center2->estimatedModuleSize - average);
+  float dB = fabsf(center1->estimatedModuleSize - average);
   return dA < dB ? -1 : dA == dB ? 0 : 1;
 }
 
+/**
+ * Stable insertion sort; there are rarely more than a handful of candidates.
+ */
+static void ZXQRCodeSortCandidates(ZXQRCodeFinderCandidate *candidates, int count, float average, ZXQRCodeFinderCandidateCompare compare) {
+  for (int i = 1; i < count; i++) {
+    ZXQRCodeFinderCandidate candidate = candidates[i];
+    int j = i - 1;
+    while (j >= 0 && compare(&candidates[j], &candidate, average) > 0) {
+      candidates[j + 1] = candidates[j];
+      j--;
+    }
+    candidates[j + 1] = candidate;
+  }
+}
+
 /**
  * @return the 3 best ZXFinderPatterns from our list of candidates. The "best" are
  *         those that have been detected at least ZXCENTER_QUORUM times, and whose module
@@ -519,7 +543,8 @@ NSInteger furthestFromAverageCompare(id center1, id center2, void *context) {
  * @return nil if 3 such finder patterns do not exist
  */
 - (NSMutableArray *)selectBestPatterns {
-  int startSize = (int)[self.possibleCenters count];
+  ZXQRCodeFinderCandidate *candidates = self.candidates;
+  int startSize = self.candidateCount;
   if (startSize < 3) {
     return nil;
   }
@@ -528,40 +553,42 @@ NSInteger furthestFromAverageCompare(id center1, id center2, void *context) {
     float totalModuleSize = 0.0f;
     float square = 0.0f;
     for (int i = 0; i < startSize; i++) {
-      float size = [self.possibleCenters[i] estimatedModuleSize];
+      float size = candidates[i].estimatedModuleSize;
       totalModuleSize += size;
       square += size * size;
     }
     float average = totalModuleSize / (float)startSize;
     float stdDev = (float)sqrt(square / startSize - average * average);
 
-    [self.possibleCenters sortUsingFunction: furthestFromAverageCompare context: (__bridge void *)@(average)];
+    ZXQRCodeSortCandidates(candidates, startSize, average, ZXQRCodeFurthestFromAverageCompare);
 
     float limit = MAX(0.2f * average, stdDev);
 
-    for (int i = 0; i < [self.possibleCenters count] && [self.possibleCenters count] > 3; i++) {
-      ZXQRCodeFinderPattern *pattern = self.possibleCenters[i];
-      if (fabsf([pattern estimatedModuleSize] - average) > limit) {
-        [self.possibleCenters removeObjectAtIndex:i];
+    for (int i = 0; i < self.candidateCount && self.candidateCount > 3; i++) {
+      if (fabsf(candidates[i].estimatedModuleSize - average) > limit) {
+        memmove(&candidates[i], &candidates[i + 1], (self.candidateCount - i - 1) * sizeof(ZXQRCodeFinderCandidate));
+        self.candidateCount--;
         i--;
       }
     }
   }
 
-  if ([self.possibleCenters count] > 3) {
+  if (self.candidateCount > 3) {
     float totalModuleSize = 0.0f;
-    for (int i = 0; i < [self.possibleCenters count]; i++) {
-      totalModuleSize += [self.possibleCenters[i] estimatedModuleSize];
+    for (int i = 0; i < self.candidateCount; i++) {
+      totalModuleSize += candidates[i].estimatedModuleSize;
     }
 
-    float average = totalModuleSize / (float)[self.possibleCenters count];
+    float average = totalModuleSize / (float)self.candidateCount;
 
-    [self.possibleCenters sortUsingFunction:centerCompare context:(__bridge void *)(@(average))];
+    ZXQRCodeSortCandidates(candidates, self.candidateCount, average, ZXQRCodeCenterCompare);
 
-    self.possibleCenters = [[NSMutableArray alloc] initWithArray:[self.possibleCenters subarrayWithRange:NSMakeRange(0, 3)]];
+    self.candidateCount = 3;
   }
 
-  return [@[self.possibleCenters[0], self.possibleCenters[1], self.possibleCenters[2]] mutableCopy];
+  return [@[[self patternForCandidate:&candidates[0]],
+            [self patternForCandidate:&candidates[1]],
+            [self patternForCandidate:&candidates[2]]] mutableCopy];
 }
 
 @end
@@ -51,7 +51,7 @@ float const ZX_DIFF_MODSIZE_CUTOFF = 0.5f;
  * size differs from the average among those patterns the least
  */
 - (NSArray *)selectBestPatternsWithError:(NSError **)error {
-  NSMutableArray *_possibleCenters = [NSMutableArray arrayWithArray:[self possibleCenters]];
+  NSMutableArray *_possibleCenters = [self possibleCenters];
   NSUInteger size = [_possibleCenters count];
 
   if (size < 3) {
@@ -86,13 +86,13 @@ float const ZX_DIFF_MODSIZE_CUTOFF = 0.5f;
   NSMutableArray *results = [NSMutableArray array];
 
   for (int i1 = 0; i1 < (size - 2); i1++) {
-    ZXQRCodeFinderPattern *p1 = self.possibleCenters[i1];
+    ZXQRCodeFinderPattern *p1 = _possibleCenters[i1];
     if (p1 == nil) {
       continue;
     }
 
     for (int i2 = i1 + 1; i2 < (size - 1); i2++) {
-      ZXQRCodeFinderPattern *p2 = self.possibleCenters[i2];
+      ZXQRCodeFinderPattern *p2 = _possibleCenters[i2];
       if (p2 == nil) {
         continue;
       }
@@ -104,7 +104,7 @@ float const ZX_DIFF_MODSIZE_CUTOFF = 0.5f;
       }
 
       for (int i3 = i2 + 1; i3 < size; i3++) {
-        ZXQRCodeFinderPattern *p3 = self.possibleCenters[i3];
+        ZXQRCodeFinderPattern *p3 = _possibleCenters[i3];
         if (p3 == nil) {
           continue;
         }
@@ -0,0 +1,79 @@
+/*
+ * Copyright 2014 ZXing authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import <XCTest/XCTest.h>
+#import "ZXingObjC.h"
+
+@interface ZXDetectionAllocationTestCase : XCTestCase
+
+@end
+
+@implementation ZXDetectionAllocationTestCase
+
+/**
+ * Renders an encoded barcode with a white margin around it, as a scan would provide it.
+ */
+- (ZXBinaryBitmap *)bitmapWithContents:(NSString *)contents format:(ZXBarcodeFormat)format {
+  NSError *error = nil;
+  ZXBitMatrix *matrix = [[ZXMultiFormatWriter writer] encode:contents format:format width:200 height:200 error:&error];
+  XCTAssertNotNil(matrix, @"Could not encode %@: %@", contents, error);
+
+  const int margin = 20;
+  int width = matrix.width + 2 * margin;
+  int height = matrix.height + 2 * margin;
+  int32_t *pixels = (int32_t *)malloc(width * height * sizeof(int32_t));
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      BOOL black = x >= margin && x < width - margin && y >= margin && y < height - margin &&
+        [matrix getX:x - margin y:y - margin];
+      pixels[y * width + x] = black ? 0xFF000000 : 0xFFFFFFFF;
+    }
+  }
+  ZXLuminanceSource *source = [[ZXRGBLuminanceSource alloc] initWithWidth:width height:height pixels:pixels pixelsLen:width * height];
+  free(pixels);
+  return [ZXBinaryBitmap binaryBitmapWithBinarizer:[ZXHybridBinarizer binarizerWithSource:source]];
+}
+
+- (void)assertCountsForReader:(id<ZXReader>)reader format:(ZXBarcodeFormat)format name:(NSString *)name {
+  NSString *contents = @"Detection allocation counts";
+  NSError *error = nil;
+  ZXResult *result = [reader decode:[self bitmapWithContents:contents format:format] error:&error];
+  XCTAssertEqualObjects(result.text, contents, @"%@ did not decode: %@", name, error);
+
+  NSNumber *candidates = result.resultMetadata[@(kResultMetadataTypeDetectionCandidateCount)];
+  NSNumber *resultPoints = result.resultMetadata[@(kResultMetadataTypeDetectionResultPointCount)];
+  XCTAssertNotNil(candidates, @"%@ did not report its candidate count", name);
+  XCTAssertNotNil(resultPoints, @"%@ did not report its result point count", name);
+  NSLog(@"%@ detection: %d candidates tracked in structs, %d result points allocated",
+        name, [candidates intValue], [resultPoints intValue]);
+  XCTAssertTrue([candidates intValue] > 0);
+  XCTAssertTrue([resultPoints intValue] < [candidates intValue],
+                @"%@ allocated %d result points for %d candidates", name, [resultPoints intValue], [candidates intValue]);
+}
+
+- (void)testQRCodeDetectionCounts {
+  [self assertCountsForReader:[[ZXQRCodeReader alloc] init] format:kBarcodeFormatQRCode name:@"QR Code"];
+}
+
+- (void)testDataMatrixDetectionCounts {
+  [self assertCountsForReader:[[ZXDataMatrixReader alloc] init] format:kBarcodeFormatDataMatrix name:@"Data Matrix"];
+}
+
+- (void)testAztecDetectionCounts {
+  [self assertCountsForReader:[[ZXAztecReader alloc] init] format:kBarcodeFormatAztec name:@"Aztec"];
+}
+
+@end
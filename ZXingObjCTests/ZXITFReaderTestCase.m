@@ -0,0 +1,124 @@
+/*
+ * Copyright 2014 ZXing authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import <XCTest/XCTest.h>
+#import "ZXingObjC.h"
+
+@interface ZXITFReader (Testing)
+
+- (BOOL)decodeMiddle:(ZXBitArray *)row payloadStart:(int)payloadStart payloadEnd:(int)payloadEnd resultString:(NSMutableString *)resultString;
+
+@end
+
+/**
+ * Counts the rows whose payload the reader goes on to decode.
+ */
+@interface ZXCountingITFReader : ZXITFReader
+
+@property (nonatomic, assign) int decodeMiddleCount;
+
+@end
+
+@implementation ZXCountingITFReader
+
+- (BOOL)decodeMiddle:(ZXBitArray *)row payloadStart:(int)payloadStart payloadEnd:(int)payloadEnd resultString:(NSMutableString *)resultString {
+  self.decodeMiddleCount++;
+  return [super decodeMiddle:row payloadStart:payloadStart payloadEnd:payloadEnd resultString:resultString];
+}
+
+@end
+
+@interface ZXITFReaderTestCase : XCTestCase
+
+@end
+
+@implementation ZXITFReaderTestCase
+
+static NSString *ZXITFTestContents = @"00123456";
+static const int ZXITFTestQuietZone = 30;
+
+/**
+ * Encodes contents one pixel per module, with a quiet zone of ZXITFTestQuietZone pixels on each side.
+ */
+- (ZXBitArray *)rowWithContents:(NSString *)contents {
+  NSError *error = nil;
+  ZXBitMatrix *matrix = [[ZXMultiFormatWriter writer] encode:contents format:kBarcodeFormatITF width:0 height:1 error:&error];
+  XCTAssertNotNil(matrix, @"Could not encode %@: %@", contents, error);
+
+  ZXBitArray *encoded = [matrix rowAtY:0 row:nil];
+  ZXBitArray *row = [[ZXBitArray alloc] initWithSize:encoded.size + 2 * ZXITFTestQuietZone];
+  for (int x = 0; x < encoded.size; x++) {
+    if ([encoded get:x]) {
+      [row set:ZXITFTestQuietZone + x];
+    }
+  }
+  return row;
+}
+
+- (ZXDecodeHints *)hintsWithAllowedLengths:(NSArray *)allowedLengths {
+  ZXDecodeHints *hints = [ZXDecodeHints hints];
+  hints.allowedLengths = allowedLengths;
+  return hints;
+}
+
+- (void)testValidRowDecodes {
+  ZXCountingITFReader *reader = [[ZXCountingITFReader alloc] init];
+  NSError *error = nil;
+  ZXResult *result = [reader decodeRow:0 row:[self rowWithContents:ZXITFTestContents] hints:nil error:&error];
+  XCTAssertEqualObjects(result.text, ZXITFTestContents, @"Valid row did not decode: %@", error);
+  XCTAssertEqual(result.barcodeFormat, kBarcodeFormatITF);
+  XCTAssertEqual(reader.decodeMiddleCount, 1);
+
+  result = [reader decodeRow:0 row:[self rowWithContents:ZXITFTestContents] hints:[self hintsWithAllowedLengths:@[@8]] error:&error];
+  XCTAssertEqualObjects(result.text, ZXITFTestContents, @"Row of an allowed length did not decode: %@", error);
+}
+
+- (void)testDisallowedLengthIsRejectedBeforeDecodingPayload {
+  ZXCountingITFReader *reader = [[ZXCountingITFReader alloc] init];
+  NSError *error = nil;
+  // Eight digits are neither allowed nor longer than every allowed length
+  ZXResult *result = [reader decodeRow:0 row:[self rowWithContents:ZXITFTestContents] hints:[self hintsWithAllowedLengths:@[@6, @10]] error:&error];
+  XCTAssertNil(result);
+  XCTAssertEqual(error.code, ZXNotFoundError);
+  XCTAssertEqual(reader.decodeMiddleCount, 0, @"The payload was decoded although its length was not allowed");
+
+  // Longer than every allowed length is allowed
+  result = [reader decodeRow:0 row:[self rowWithContents:ZXITFTestContents] hints:[self hintsWithAllowedLengths:@[@6]] error:&error];
+  XCTAssertEqualObjects(result.text, ZXITFTestContents);
+  XCTAssertEqual(reader.decodeMiddleCount, 1);
+}
+
+- (void)testQuietZoneBeforeStartPattern {
+  ZXCountingITFReader *reader = [[ZXCountingITFReader alloc] init];
+  ZXBitArray *row = [self rowWithContents:ZXITFTestContents];
+  int start = [row nextSet:0];
+
+  // A narrow bar four modules before the start pattern, inside its ten module quiet zone
+  [row set:start - 4];
+  NSError *error = nil;
+  ZXResult *result = [reader decodeRow:0 row:row hints:nil error:&error];
+  XCTAssertNil(result);
+  XCTAssertEqual(error.code, ZXNotFoundError);
+  XCTAssertEqual(reader.decodeMiddleCount, 0);
+
+  // Further away than the quiet zone, the bar does not matter
+  row = [self rowWithContents:ZXITFTestContents];
+  [row set:start - 15];
+  result = [reader decodeRow:0 row:row hints:nil error:&error];
+  XCTAssertEqualObjects(result.text, ZXITFTestContents, @"Row with a clear quiet zone did not decode: %@", error);
+}
+
+@end
@@ -0,0 +1,104 @@
+/*
+ * Copyright 2014 ZXing authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#import <XCTest/XCTest.h>
+#import "ZXingObjC.h"
+
+@interface ZXSharedMultiFormatReaderTestCase : XCTestCase
+
+@end
+
+@implementation ZXSharedMultiFormatReaderTestCase
+
+/**
+ * Renders an encoded barcode as a luminance source, as a camera frame or scan would provide it.
+ */
+- (ZXLuminanceSource *)sourceWithContents:(NSString *)contents format:(ZXBarcodeFormat)format {
+  NSError *error = nil;
+  ZXBitMatrix *matrix = [[ZXMultiFormatWriter writer] encode:contents format:format width:200 height:200 error:&error];
+  XCTAssertNotNil(matrix, @"Could not encode %@: %@", contents, error);
+
+  int width = matrix.width;
+  int height = matrix.height;
+  int32_t *pixels = (int32_t *)malloc(width * height * sizeof(int32_t));
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      pixels[y * width + x] = [matrix getX:x y:y] ? 0xFF000000 : 0xFFFFFFFF;
+    }
+  }
+  ZXLuminanceSource *source = [[ZXRGBLuminanceSource alloc] initWithWidth:width height:height pixels:pixels pixelsLen:width * height];
+  free(pixels);
+  return source;
+}
+
+- (void)testHintsAreCopiedCompletely {
+  ZXDecodeHints *hints = [ZXDecodeHints hints];
+  hints.assumeGS1 = YES;
+  hints.allowedEANExtensions = [[ZXIntArray alloc] initWithInts:2, 5, -1];
+  [hints addPossibleFormat:kBarcodeFormatEan13];
+
+  ZXSharedMultiFormatReader *reader = [ZXSharedMultiFormatReader readerWithHints:hints];
+  XCTAssertTrue(reader.hints.assumeGS1);
+  XCTAssertEqual(reader.hints.allowedEANExtensions.length, 2u);
+  XCTAssertEqual(reader.hints.allowedEANExtensions.array[0], 2);
+  XCTAssertEqual(reader.hints.allowedEANExtensions.array[1], 5);
+  XCTAssertTrue([reader.hints containsFormat:kBarcodeFormatEan13]);
+}
+
+- (void)testParallelDecodeThroughOneReader {
+  ZXDecodeHints *hints = [ZXDecodeHints hints];
+  [hints addPossibleFormat:kBarcodeFormatQRCode];
+  [hints addPossibleFormat:kBarcodeFormatCode128];
+  ZXSharedMultiFormatReader *reader = [ZXSharedMultiFormatReader readerWithHints:hints];
+
+  NSArray *contents = @[@"Shared reader 1", @"SHARED-READER-2", @"Shared reader 3", @"SHARED-READER-4"];
+  NSArray *formats = @[@(kBarcodeFormatQRCode), @(kBarcodeFormatCode128), @(kBarcodeFormatQRCode), @(kBarcodeFormatCode128)];
+  NSMutableArray *sources = [NSMutableArray array];
+  for (int i = 0; i < [contents count]; i++) {
+    [sources addObject:[self sourceWithContents:contents[i] format:[formats[i] intValue]]];
+  }
+
+  ZXDecodeHints *qrCodeHints = [ZXDecodeHints hints];
+  [qrCodeHints addPossibleFormat:kBarcodeFormatQRCode];
+
+  const int iterations = 200;
+  __block int failures = 0;
+  NSObject *lock = [[NSObject alloc] init];
+  dispatch_apply(iterations, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t iteration) {
+    NSUInteger index = iteration % [sources count];
+    // Each call has its own bitmap and binarizer, only the reader is shared
+    ZXBinaryBitmap *bitmap = [ZXBinaryBitmap binaryBitmapWithBinarizer:[ZXHybridBinarizer binarizerWithSource:sources[index]]];
+
+    ZXResult *result;
+    if (iteration % 5 == 0 && [formats[index] intValue] == kBarcodeFormatQRCode) {
+      // Mix in calls with other hints, which must not leak into the other decodes
+      result = [reader decode:bitmap hints:qrCodeHints error:nil];
+    } else {
+      result = [reader decode:bitmap error:nil];
+    }
+
+    if (![result.text isEqualToString:contents[index]] || result.barcodeFormat != [formats[index] intValue]) {
+      @synchronized (lock) {
+        failures++;
+      }
+    }
+  });
+
+  XCTAssertEqual(failures, 0, @"%d of %d parallel decodes failed", failures, iterations);
+  XCTAssertTrue([reader.hints containsFormat:kBarcodeFormatCode128]);
+}
+
+@end